@@ -0,0 +1,128 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/scope.h"
+#include "../base/tag_type.h"
+#include "../container/container.h"
+#include "../container/insert.h"
+#include "break_or_continue.h"
+#include "element.h"
+#include "empty.h"
+#include "minmax.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace tc {
+	DEFINE_TAG_TYPE(unordered_tag)
+
+	// Calls funcBatch(iBatch) for all iBatch in [0, nBatches) on all cores. funcBatch returns a tc::vector of results, and is called concurrently.
+	// The results are passed to sink on the calling thread, in batch order, or with unordered_tag in the order in which the batches are done.
+	// An exception thrown by funcBatch stops the remaining batches and is rethrown on the calling thread.
+	template<typename FuncBatch, typename Sink, typename... Tag>
+	auto for_each_batch_parallel(std::size_t const nBatches, FuncBatch const& funcBatch, Sink&& sink, Tag...) MAYTHROW {
+		constexpr bool c_bOrdered = !(std::is_same<Tag, tc::unordered_tag_t>::value || ...);
+		using vecresult_t = decltype(funcBatch(std::declval<std::size_t>()));
+		using return_t = tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<tc::range_value_t<vecresult_t>>())), tc::constant<tc::continue_>>;
+
+		auto const nThreads = tc::min(tc::max(std::thread::hardware_concurrency(), 1u), nBatches);
+		auto const nBatchesInFlight = 4 * nThreads; // bounds the memory for results that are waiting for an earlier batch
+
+		std::mutex mtx;
+		std::condition_variable cvWorker; // signaled when a batch may be started or all workers must stop
+		std::condition_variable cvSink; // signaled when a batch is done or failed
+		// Guarded by mtx:
+		std::size_t iBatchNext = 0;
+		std::size_t nBatchesSunk = 0;
+		tc::vector<std::optional<vecresult_t>> vecovecresult(nBatches); // batches that are done and not yet passed to sink
+		tc::vector<std::size_t> veciBatchDone; // unordered only, in the order in which they are done
+		std::exception_ptr pexception;
+		bool bStop = false;
+
+		auto const Worker = [&]() noexcept {
+			for (;;) {
+				std::size_t iBatch;
+				{
+					std::unique_lock lock(mtx);
+					cvWorker.wait(lock, [&]() noexcept {
+						return bStop || nBatches == iBatchNext || iBatchNext < nBatchesSunk + nBatchesInFlight;
+					});
+					if (bStop || nBatches == iBatchNext) return;
+					iBatch = iBatchNext++;
+				}
+
+				try {
+					auto vecresult = funcBatch(iBatch); // MAYTHROW
+					{
+						std::scoped_lock lock(mtx);
+						vecovecresult[iBatch].emplace(tc_move(vecresult));
+						if constexpr (!c_bOrdered) tc::cont_emplace_back(veciBatchDone, iBatch);
+					}
+					cvSink.notify_one();
+				} catch (...) {
+					{
+						std::scoped_lock lock(mtx);
+						if (!pexception) pexception = std::current_exception();
+						bStop = true;
+					}
+					cvSink.notify_one();
+					cvWorker.notify_all();
+					return;
+				}
+			}
+		};
+
+		tc::vector<std::thread> vecthread;
+		tc_scope_exit {
+			{
+				std::scoped_lock lock(mtx);
+				bStop = true;
+			}
+			cvWorker.notify_all();
+			for (auto& thread : vecthread) thread.join();
+		};
+		for (std::size_t i = 0; i < nThreads; ++i) {
+			tc::cont_emplace_back(vecthread, Worker); // MAYTHROW
+		}
+
+		while (nBatches != nBatchesSunk) {
+			vecresult_t vecresult;
+			{
+				std::unique_lock lock(mtx);
+				cvSink.wait(lock, [&]() noexcept {
+					if constexpr (c_bOrdered) {
+						return pexception || vecovecresult[nBatchesSunk];
+					} else {
+						return pexception || !tc::empty(veciBatchDone);
+					}
+				});
+				if (pexception) {
+					lock.unlock(); // the workers are joined while unwinding
+					std::rethrow_exception(pexception);
+				}
+				auto& ovecresult = vecovecresult[c_bOrdered ? nBatchesSunk : tc::back(veciBatchDone)];
+				if constexpr (!c_bOrdered) tc::drop_last_inplace(veciBatchDone);
+				vecresult = tc_move_always(*ovecresult);
+				ovecresult.reset();
+				++nBatchesSunk;
+			}
+			cvWorker.notify_one();
+
+			for (auto& result : vecresult) {
+				tc_return_if_break(return_t(tc::continue_if_not_break(sink, tc_move_always(result)))); // MAYTHROW
+			}
+		}
+		return return_t(tc::constant<tc::continue_>());
+	}
+}
@@ -0,0 +1,116 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../container/cont_reserve.h"
+#include "../container/container.h"
+#include "range_adaptor.h"
+#include "subrange.h"
+
+#include <istream>
+
+namespace tc {
+	namespace buffered_input_range_detail {
+		inline constexpr std::size_t c_nDefaultChunkSize = 1 << 16;
+	}
+
+	namespace no_adl {
+		// Forward range over input that is read on demand, e.g., from a stream. Only a sliding window of the input is held in memory:
+		// reader(pch, n) writes up to n code units to pch and returns how many it has written, 0 only at the end of the input.
+		// discard_until(idx) declares that no index before idx is dereferenced anymore, so that the next refill may drop that part of the window.
+		// tc::xml::parser calls discard_until before each entity, so multi-GB documents are parsed with memory bounded by the largest entity.
+		// Indices are absolute positions in the input and remain valid across refills.
+		template<typename Char, typename Reader>
+		struct [[nodiscard]] buffered_input_range
+			: tc::range_iterator_from_index<buffered_input_range<Char, Reader>, std::size_t>
+			, tc::noncopyable // iterators refer to the range
+		{
+		private:
+			using this_type = buffered_input_range;
+		public:
+			using typename this_type::range_iterator_from_index::tc_index;
+			static constexpr bool c_bHasStashingIndex=false;
+
+			explicit buffered_input_range(Reader reader, std::size_t const nChunkSize = buffered_input_range_detail::c_nDefaultChunkSize) noexcept
+				: m_reader(tc_move(reader))
+				, m_nChunkSize(nChunkSize)
+			{
+				_ASSERT(0 < m_nChunkSize);
+			}
+
+			void discard_until(tc_index const idx) & noexcept {
+				_ASSERT(m_idxDiscard <= idx);
+				m_idxDiscard = idx;
+			}
+
+		private:
+			STATIC_FINAL(begin_index)() const& noexcept -> tc_index {
+				return 0;
+			}
+
+			STATIC_FINAL(at_end_index)(tc_index const idx) const& MAYTHROW -> bool {
+				return !load(idx); // MAYTHROW
+			}
+
+			STATIC_FINAL(increment_index)(tc_index& idx) const& noexcept -> void {
+				++idx;
+			}
+
+			STATIC_FINAL(decrement_index)(tc_index& idx) const& noexcept -> void {
+				--idx;
+			}
+
+			STATIC_FINAL(dereference_index)(tc_index const idx) const& MAYTHROW -> Char {
+				VERIFY(load(idx)); // MAYTHROW
+				return m_vecch[idx - m_idxWindow];
+			}
+
+			// Reads until idx is in the window. Returns false if the input ends before idx.
+			bool load(tc_index const idx) const& MAYTHROW {
+				_ASSERT(m_idxDiscard <= idx); // the part of the window before m_idxDiscard may be gone
+				while (m_idxWindow + tc::size(m_vecch) <= idx) {
+					if (m_bEnd) return false;
+					// Drop the discarded part. In the common case, the rest of the window is a fraction of an entity, and moving it is cheap.
+					tc::drop_first_inplace(m_vecch, m_idxDiscard - m_idxWindow);
+					m_idxWindow = m_idxDiscard;
+					auto const nSize = tc::size(m_vecch);
+					tc::cont_extend(m_vecch, nSize + m_nChunkSize);
+					auto const nRead = m_reader(tc::ptr_begin(m_vecch) + nSize, m_nChunkSize); // MAYTHROW
+					_ASSERT(nRead <= m_nChunkSize);
+					tc::take_first_inplace(m_vecch, nSize + nRead);
+					m_bEnd = 0 == nRead;
+				}
+				return true;
+			}
+
+			mutable Reader m_reader;
+			std::size_t m_nChunkSize;
+			mutable tc::vector<Char> m_vecch;
+			mutable tc_index m_idxWindow = 0; // the index of the first element of m_vecch
+			tc_index m_idxDiscard = 0;
+			mutable bool m_bEnd = false;
+		};
+	}
+	using no_adl::buffered_input_range;
+
+	template<typename Char, typename Reader>
+	auto make_buffered_input_range(Reader reader, std::size_t const nChunkSize = buffered_input_range_detail::c_nDefaultChunkSize) noexcept {
+		return no_adl::buffered_input_range<Char, Reader>(tc_move(reader), nChunkSize);
+	}
+
+	// Reading fails like the stream does, i.e., throws if exceptions are enabled on is, and otherwise ends the range.
+	template<typename Char, typename Traits>
+	auto make_buffered_input_range(std::basic_istream<Char, Traits>& is, std::size_t const nChunkSize = buffered_input_range_detail::c_nDefaultChunkSize) noexcept {
+		return tc::make_buffered_input_range<Char>([&is](Char* const pch, std::size_t const n) MAYTHROW {
+			is.read(pch, tc::explicit_cast<std::streamsize>(n)); // MAYTHROW
+			return tc::explicit_cast<std::size_t>(is.gcount());
+		}, nChunkSize);
+	}
+}
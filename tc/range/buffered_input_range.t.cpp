@@ -0,0 +1,64 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "buffered_input_range.h"
+#include "../string/format.h"
+#include "../string/xmlparser.h"
+
+#include <sstream>
+
+UNITTESTDEF(buffered_input_range) {
+	{
+		std::istringstream is("");
+		auto rng = tc::make_buffered_input_range(is, 3);
+		_ASSERT(tc::empty(rng));
+	}
+	{
+		std::istringstream is("abcdefgh");
+		auto rng = tc::make_buffered_input_range(is, 3);
+		_ASSERT(tc::equal(rng, "abcdefgh"));
+	}
+	{
+		// Arbitrary chunk boundaries
+		std::size_t nRead = 0;
+		auto rng = tc::make_buffered_input_range<char>([&](char* const pch, std::size_t const n) noexcept -> std::size_t {
+			if (10 == nRead) return 0;
+			*pch = static_cast<char>('0' + nRead++);
+			_ASSERT(0 < n);
+			return 1;
+		});
+		_ASSERT(tc::equal(rng, "0123456789"));
+	}
+	{
+		// The parser releases everything before the current entity, so it only holds a few chunks at a time.
+		tc::string<char> str = "<root>";
+		for (int i = 0; i < 1000; ++i) {
+			tc::append(str, "<item id=\"", tc::as_dec(i), "\" xmlns:p=\"urn:p\"><p:text>", tc::as_dec(i * i), "</p:text><!-- comment --></item>\n");
+		}
+		tc::append(str, "</root>");
+
+		std::istringstream is(std::string(tc::ptr_begin(str), tc::size(str)));
+		auto rng = tc::make_buffered_input_range(is, 64);
+		auto parser = tc::xml::make_parser(rng, tc::xml::throw_parse_error);
+		auto const nsP = parser.register_namespace("urn:p");
+		parser.expect_child("root");
+		int n = 0;
+		while (parser.child("item")) {
+			_ASSERTEQUAL(parser.expect_parse_attribute(tc::xml::integer<int>, "id"), n);
+			parser.expect_child(nsP, "text");
+			_ASSERTEQUAL(parser.expect_parse_characters(tc::xml::integer<int>), n * n);
+			parser.expect_element_end();
+			parser.expect_element_end();
+			++n;
+		}
+		_ASSERTEQUAL(n, 1000);
+		parser.expect_element_end();
+		parser.expect_end();
+	}
+}
@@ -0,0 +1,120 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/noncopyable.h"
+#include "../base/scope.h"
+
+#include <boost/predef/os.h>
+
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#if BOOST_OS_WINDOWS
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#else
+#	include <cerrno>
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace tc {
+	namespace no_adl {
+		// Read-only memory mapping of a whole file. The mapping is a contiguous and common range, so parsers on it take their vectorized paths,
+		// without copying the file into a string first. Pages are read on demand, and the OS is told that they will be accessed sequentially.
+		// A trailing partial Char is not part of the range.
+		template<typename Char = char>
+		struct [[nodiscard]] mapped_file_range final : tc::noncopyable {
+			static_assert(std::is_trivially_copyable<Char>::value);
+
+			explicit mapped_file_range(std::filesystem::path const& path) THROW(std::system_error) {
+#if BOOST_OS_WINDOWS
+				HANDLE const hfile = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (INVALID_HANDLE_VALUE == hfile) throw_last_error();
+				tc_scope_exit { ::CloseHandle(hfile); };
+				LARGE_INTEGER nSize;
+				if (!::GetFileSizeEx(hfile, &nSize)) throw_last_error();
+				m_nSize = static_cast<std::size_t>(nSize.QuadPart) / sizeof(Char);
+				if (0 < m_nSize) {
+					HANDLE const hmapping = ::CreateFileMappingW(hfile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (nullptr == hmapping) throw_last_error();
+					tc_scope_exit { ::CloseHandle(hmapping); }; // the view keeps the mapping alive
+					m_pch = static_cast<Char const*>(::MapViewOfFile(hmapping, FILE_MAP_READ, 0, 0, 0));
+					if (nullptr == m_pch) throw_last_error();
+				}
+#else
+				int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+				if (-1 == fd) throw_last_error();
+				tc_scope_exit { ::close(fd); }; // the mapping stays valid after closing the file
+				struct stat st;
+				if (-1 == ::fstat(fd, &st)) throw_last_error();
+				m_nSize = static_cast<std::size_t>(st.st_size) / sizeof(Char);
+				if (0 < m_nSize) { // mapping 0 bytes fails
+					void* const pv = ::mmap(nullptr, m_nSize * sizeof(Char), PROT_READ, MAP_PRIVATE, fd, 0);
+					if (MAP_FAILED == pv) throw_last_error();
+					m_pch = static_cast<Char const*>(pv);
+					// Only a hint: read ahead aggressively and free pages behind the reader early.
+					::madvise(pv, m_nSize * sizeof(Char), MADV_SEQUENTIAL);
+				}
+#endif
+			}
+
+			mapped_file_range(mapped_file_range&& other) noexcept
+				: m_pch(std::exchange(other.m_pch, nullptr))
+				, m_nSize(std::exchange(other.m_nSize, 0))
+			{}
+
+			mapped_file_range& operator=(mapped_file_range&& other) & noexcept {
+				std::swap(m_pch, other.m_pch);
+				std::swap(m_nSize, other.m_nSize);
+				return *this;
+			}
+
+			~mapped_file_range() {
+				if (m_pch) {
+#if BOOST_OS_WINDOWS
+					VERIFY(::UnmapViewOfFile(m_pch));
+#else
+					VERIFY(0 == ::munmap(const_cast<Char*>(m_pch), m_nSize * sizeof(Char)));
+#endif
+				}
+			}
+
+			Char const* begin() const& noexcept {
+				return m_pch;
+			}
+			Char const* end() const& noexcept {
+				return m_pch + m_nSize;
+			}
+			std::size_t size() const& noexcept {
+				return m_nSize;
+			}
+
+		private:
+			[[noreturn]] static void throw_last_error() THROW(std::system_error) {
+#if BOOST_OS_WINDOWS
+				throw std::system_error(static_cast<int>(::GetLastError()), std::system_category());
+#else
+				throw std::system_error(errno, std::generic_category());
+#endif
+			}
+
+			Char const* m_pch = nullptr;
+			std::size_t m_nSize = 0;
+		};
+	}
+	using no_adl::mapped_file_range;
+}
@@ -0,0 +1,80 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "mapped_file_range.h"
+#include "../string/jsonparser.h"
+#include "../string/xmlparser.h"
+
+#include <fstream>
+
+namespace {
+	struct STempFile final : tc::nonmovable {
+		explicit STempFile(char const* const szName, auto const& str) noexcept
+			: m_path(std::filesystem::temp_directory_path() / szName)
+		{
+			std::ofstream ofs(m_path, std::ios::binary);
+			ofs.write(tc::ptr_begin(str), tc::size(str));
+			_ASSERT(ofs);
+		}
+		~STempFile() {
+			std::error_code ec;
+			std::filesystem::remove(m_path, ec);
+		}
+
+		std::filesystem::path m_path;
+	};
+}
+
+STATICASSERTSAME(tc::iterator_t<tc::mapped_file_range<> const>, char const*);
+static_assert(tc::contiguous_range<tc::mapped_file_range<>> && tc::common_range<tc::mapped_file_range<>>);
+
+UNITTESTDEF(mapped_file_range) {
+	{
+		STempFile const file("tc_mapped_file_range.json", tc::make_str(R"({"a": [1, 2, 3], "b": "text"})"));
+		tc::mapped_file_range<> const rng(file.m_path);
+		_ASSERTEQUAL(tc::size(rng), 29);
+		_ASSERT(tc::equal(rng, R"({"a": [1, 2, 3], "b": "text"})"));
+
+		tc::json::parser parser(rng, tc::json::simple_error_handler(tc::never_called()));
+		parser.expect_object();
+		_ASSERT(tc::equal(*parser.key(), "a"));
+		parser.skip_value();
+		_ASSERT(tc::equal(*parser.key(), "b"));
+		_ASSERT(tc::equal(parser.expect_string(), "text"));
+		_ASSERT(!parser.key());
+		parser.expect_end();
+
+		auto rngMoved = tc_move_always(tc::as_mutable(rng));
+		_ASSERT(tc::empty(rng));
+		_ASSERTEQUAL(tc::size(rngMoved), 29);
+	}
+	{
+		STempFile const file("tc_mapped_file_range.xml", tc::make_str("<a x='1'>text</a>"));
+		auto parser = tc::xml::make_parser(tc::mapped_file_range<>(file.m_path), tc::xml::throw_parse_error); // the parser owns the mapping
+		parser.expect_child("a");
+		_ASSERT(tc::equal(*parser.attribute("x"), "1"));
+		_ASSERT(tc::equal(parser.characters(), "text"));
+		parser.expect_element_end();
+	}
+	{
+		STempFile const file("tc_mapped_file_range_empty", tc::make_str(""));
+		_ASSERT(tc::empty(tc::mapped_file_range<>(file.m_path)));
+	}
+	{
+		// A trailing partial code unit is ignored.
+		STempFile const file("tc_mapped_file_range_odd", tc::make_str("abc"));
+		_ASSERTEQUAL(tc::size(tc::mapped_file_range<char16_t>(file.m_path)), 1);
+	}
+	try {
+		tc::mapped_file_range<> const rng(std::filesystem::temp_directory_path() / "tc_mapped_file_range_does_not_exist");
+		_ASSERTFALSE;
+	} catch (std::system_error const& err) {
+		_ASSERT(std::errc::no_such_file_or_directory == err.code());
+	}
+}
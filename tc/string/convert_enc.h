@@ -14,8 +14,13 @@
 #include "../algorithm/empty.h"
 #include "../algorithm/compare.h"
 #include "../range/range_adaptor.h"
+#include "../range/subrange.h"
 
 #include "char.h"
+#include "simd.h"
+
+#include <array>
+#include <bit>
 
 namespace tc {
 	// Code unit predicates
@@ -266,6 +271,139 @@ namespace tc {
 	}
 
 	namespace convert_enc_impl {
+		template<typename Rng>
+		concept contiguous_string = tc::contiguous_range<Rng const&> && tc::common_range<Rng const&>;
+
+		// Transcodes contiguous input a buffer at a time and passes the buffers to sink, so that an appender inserts them at once.
+		// Runs of ASCII are found a whole vector at a time and copied by a loop the compiler vectorizes. All other code points are
+		// converted like by the lazy ranges below, including the replacement of ill-formed sequences by U+FFFD.
+		template<typename Dst, typename Src, typename Sink>
+		auto transcode(Src const* pch, Src const* const pchEnd, Sink const& sink) MAYTHROW {
+			using buffer_t = std::array<Dst, 512>;
+			using return_t = tc::common_type_t<
+				decltype(tc::for_each(tc::make_iterator_range(std::declval<Dst const*>(), std::declval<Dst const*>()), sink)),
+				tc::constant<tc::continue_>
+			>;
+
+			buffer_t ach;
+			while (pch != pchEnd) {
+				Dst* pchDst = ach.data();
+				auto const pchDstEnd = pchDst + (tc::size(ach) - tc::char_limits<Dst>::c_nMaxCodeUnitsPerCodePoint); // room for one more code point
+				do {
+					if constexpr (sizeof(Src) <= 2) {
+						auto const pchAsciiEnd = tc::simd::find_first_of<tc::simd::code_unit_set<0, 0x7F>>(pch, pch + tc::min(pchEnd - pch, pchDstEnd - pchDst));
+						for (; pch != pchAsciiEnd; ++pch, ++pchDst) {
+							*pchDst = static_cast<Dst>(*pch);
+						}
+						if (pchEnd == pch || pchDstEnd == pchDst) break;
+					}
+
+					char32_t ch32 = U'\uFFFD'; // REPLACEMENT CHARACTER
+					if constexpr (std::same_as<Src, char32_t>) {
+						if (auto const n = tc::to_underlying(*pch); VERIFYNOTIFY(n<0x110000u) && VERIFYNOTIFY(n<0xd800u || 0xdfffu<n)) {
+							ch32 = *pch;
+						}
+						++pch;
+					} else {
+						auto const rng = tc::make_iterator_range(pch, pchEnd);
+						if (auto const och = VERIFYNOTIFY(tc::codepoint_value_impl(rng, pch))) {
+							ch32 = *och;
+						}
+						VERIFYNOTIFYEQUAL(tc::codepoint_increment_index(rng, pch), ecodeunitseqtypVALID);
+					}
+
+					if constexpr (std::same_as<Dst, char32_t>) {
+						*pchDst++ = ch32;
+					} else {
+						auto const nCodePoint = tc::to_underlying(ch32);
+						for (int i = 0; i < tc::codepoint_codeunit_count<Dst>(nCodePoint); ++i) {
+							*pchDst++ = tc::codepoint_codeunit_at<Dst>(nCodePoint, i);
+						}
+					}
+				} while (pchEnd != pch && pchDst < pchDstEnd);
+
+				tc_return_if_break(return_t(tc::for_each(tc::make_iterator_range(tc::as_const(ach).data(), tc::implicit_cast<Dst const*>(pchDst)), sink))) // MAYTHROW
+			}
+			return return_t(tc::constant<tc::continue_>());
+		}
+
+		template<typename Dst, typename Rng, typename Sink>
+		auto transcode(Rng const& rng, Sink const& sink) MAYTHROW {
+			auto const pch = tc::ptr_begin(rng);
+			return transcode<Dst>(pch, pch + tc::size(rng), sink); // MAYTHROW
+		}
+
+		struct SCountCodeUnits final {
+			std::size_t& m_n;
+
+			template<typename Rng>
+			void chunk(Rng const& rng) const& noexcept {
+				m_n += tc::size(rng);
+			}
+		};
+
+		// Returns the number of code units transcode passes to its sink. Well-formed input is counted a whole vector at a time.
+		template<typename Dst, typename Src>
+		std::size_t transcoded_size(Src const* pch, Src const* const pchEnd) noexcept {
+			auto const CountByTranscoding = [&]() noexcept {
+				std::size_t n = 0;
+				transcode<Dst>(pch, pchEnd, SCountCodeUnits{n});
+				return n;
+			};
+
+			std::size_t n = 0;
+			if constexpr (std::same_as<Src, char32_t>) {
+				// U+FFFD, which replaces invalid code points, takes as many code units as the surrogates do.
+				for (; pch != pchEnd; ++pch) {
+					auto const nCodePoint = tc::to_underlying(*pch);
+					bool const bSupplementary = 0x10000u <= nCodePoint && nCodePoint < 0x110000u;
+					if constexpr (std::same_as<Dst, char>) {
+						n += 1 + (0x80u <= nCodePoint) + (0x800u <= nCodePoint) + bSupplementary;
+					} else {
+						n += 1 + bSupplementary;
+					}
+				}
+			} else if constexpr (1 == sizeof(Src)) {
+				if (pchEnd != tc::simd::find_first_invalid_utf8(pch, pchEnd)) return CountByTranscoding();
+				// Every code point has one code unit that is not a continuation byte. Only 4-byte sequences need surrogate pairs.
+				using not_continuation_t = tc::simd::code_unit_set<0x80, 0xBF>;
+				using leading_4_byte_t = tc::simd::code_unit_set<0, 0xEF>;
+				for (; 64 <= pchEnd - pch; pch += 64) {
+					auto const anMask = tc::simd::block_masks<not_continuation_t, leading_4_byte_t>(pch);
+					n += std::popcount(anMask[0]);
+					if constexpr (std::same_as<Dst, tc::char16>) n += std::popcount(anMask[1]);
+				}
+				for (; pch != pchEnd; ++pch) {
+					n += not_continuation_t::contains(*pch);
+					if constexpr (std::same_as<Dst, tc::char16>) n += leading_4_byte_t::contains(*pch);
+				}
+			} else {
+				// Surrogates must come in pairs, each of which encodes a code point that takes 4 bytes in UTF-8 or 1 code unit in UTF-32.
+				using not_surrogate_t = tc::simd::code_unit_set<0xD800, 0xDFFF>;
+				std::size_t nPairs = 0;
+				for (auto pchSurrogate = pch;; pchSurrogate += 2, ++nPairs) {
+					pchSurrogate = tc::simd::find_first_not_of<not_surrogate_t>(pchSurrogate, pchEnd);
+					if (pchEnd == pchSurrogate) break;
+					if (!tc::is_leading_codeunit(*pchSurrogate) || pchEnd == pchSurrogate + 1 || !tc::is_trailing_codeunit(pchSurrogate[1])) return CountByTranscoding();
+				}
+				if constexpr (std::same_as<Dst, char>) {
+					for (; pch != pchEnd; ++pch) {
+						auto const nCodeUnit = tc::to_underlying(*pch);
+						n += 1 + (0x80u <= nCodeUnit) + (0x800u <= nCodeUnit) - !not_surrogate_t::contains(*pch);
+					}
+				} else {
+					n = tc::explicit_cast<std::size_t>(pchEnd - pch) - nPairs;
+				}
+			}
+			return n;
+		}
+
+		template<typename Dst, typename Rng>
+		std::size_t transcoded_size(Rng const& rng) noexcept {
+			auto const pch = tc::ptr_begin(rng);
+			return transcoded_size<Dst>(pch, pch + tc::size(rng));
+		}
+
 		template <typename Dst, typename Rng, typename Src=tc::range_value_t<Rng>>
 		struct SStringConversionRange;
 
@@ -326,6 +464,16 @@ namespace tc {
 			static constexpr auto border_base_index(tc_index const& idx) noexcept {
 				return idx;
 			}
+
+			template<typename Sink>
+			auto operator()(Sink const& sink) const& MAYTHROW requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcode<char32_t>(this->base_range(), sink); // MAYTHROW
+			}
+
+			// Exact, so that appending reserves once.
+			auto size() const& noexcept requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcoded_size<char32_t>(this->base_range());
+			}
 		};
 
 		template<typename Index>
@@ -415,6 +563,16 @@ namespace tc {
 				_ASSERTE(0==idx.m_nCodeUnitIndex);
 				return idx.m_idx;
 			}
+
+			template<typename Sink>
+			auto operator()(Sink const& sink) const& MAYTHROW requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcode<Char>(this->base_range(), sink); // MAYTHROW
+			}
+
+			// Exact, so that appending reserves once.
+			auto size() const& noexcept requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcoded_size<Char>(this->base_range());
+			}
 		};
 
 		// Lazily convert UTF-32 strings to UTF-16
@@ -465,6 +623,17 @@ namespace tc {
 			)
 
 			RVALUE_THIS_OVERLOAD_MOVABLE_MUTABLE_REF(base_range)
+
+			// Transcodes directly, without the intermediate UTF-32 range.
+			template<typename Sink>
+			auto operator()(Sink const& sink) const& MAYTHROW requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcode<char>(base_range(), sink); // MAYTHROW
+			}
+
+			// Exact, so that appending reserves once.
+			auto size() const& noexcept requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcoded_size<char>(base_range());
+			}
 		};
 
 		template<typename Rng>
@@ -490,6 +659,17 @@ namespace tc {
 			)
 
 			RVALUE_THIS_OVERLOAD_MOVABLE_MUTABLE_REF(base_range)
+
+			// Transcodes directly, without the intermediate UTF-32 range.
+			template<typename Sink>
+			auto operator()(Sink const& sink) const& MAYTHROW requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcode<tc::char16>(base_range(), sink); // MAYTHROW
+			}
+
+			// Exact, so that appending reserves once.
+			auto size() const& noexcept requires contiguous_string<std::remove_reference_t<Rng>> {
+				return transcoded_size<tc::char16>(base_range());
+			}
 		};
 	} // namespace convert_enc_impl
 
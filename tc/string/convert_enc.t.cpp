@@ -7,7 +7,16 @@
 // See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
 
 #include "../base/assert_defs.h"
+#include "../unittest.h"
 #include "convert_enc.h"
+#include "../algorithm/append.h"
+#include "../container/insert.h"
+#include "../range/transform_adaptor.h"
+#include "../range/repeat_n.h"
+#include "../range/subrange.h"
+
+#include <random>
+#include <string_view>
 
 namespace {
 	// Only one of is_single_codeunit, is_leading_codeunit, and is_trailing_codeunit should be true for a code unit. These predicates help asserting this.
@@ -49,3 +58,90 @@ static_assert(IsLeading(tc_utf16('\xD800')));
 static_assert(IsLeading(tc_utf16('\xDBFF')));
 static_assert(IsTrailing(tc_utf16('\xDC00')));
 static_assert(IsTrailing(tc_utf16('\xDFFF')));
+
+namespace {
+	template<typename Char>
+	tc::string<Char> Encode(tc::vector<char32_t> const& vecch32) noexcept {
+		tc::string<Char> str;
+		tc::for_each(vecch32, [&](char32_t const ch32) noexcept {
+			for (int i = 0; i < tc::codepoint_codeunit_count<Char>(tc::to_underlying(ch32)); ++i) {
+				tc::cont_emplace_back(str, tc::codepoint_codeunit_at<Char>(tc::to_underlying(ch32), i));
+			}
+		});
+		return str;
+	}
+
+	template<typename Dst, typename Src>
+	void CheckConvertEnc(tc::string<Src> const& strSrc, tc::string<Dst> const& strDst) noexcept {
+		_ASSERT(tc::equal(tc::make_str<Dst>(tc::convert_enc<Dst>(strSrc)), strDst)); // buffered transcoding of contiguous input
+		_ASSERT(tc::equal(tc::make_str<Dst>(tc::convert_enc<Dst>(tc::transform(strSrc, tc::identity()))), strDst)); // lazy conversion
+		_ASSERT(tc::equal(tc::convert_enc<Dst>(strSrc), strDst)); // iterators
+		_ASSERTEQUAL(tc::size(tc::convert_enc<Dst>(strSrc)), tc::size(strDst));
+	}
+}
+
+UNITTESTDEF(convert_enc_transcode) {
+	// Mostly ASCII with some longer code points, long enough to fill several buffers.
+	std::mt19937 gen(42);
+	for (int i = 0; i < 100; ++i) {
+		tc::vector<char32_t> vecch32;
+		auto const n = std::uniform_int_distribution<int>(0, 2000)(gen);
+		for (int j = 0; j < n; ++j) {
+			switch (std::uniform_int_distribution<int>(0, 9)(gen)) {
+			case 0: tc::cont_emplace_back(vecch32, static_cast<char32_t>(std::uniform_int_distribution<unsigned int>(0x80u, 0xD7FFu)(gen))); break;
+			case 1: tc::cont_emplace_back(vecch32, static_cast<char32_t>(std::uniform_int_distribution<unsigned int>(0xE000u, 0x10FFFFu)(gen))); break;
+			default: tc::cont_emplace_back(vecch32, static_cast<char32_t>(std::uniform_int_distribution<unsigned int>(0u, 0x7Fu)(gen))); break;
+			}
+		}
+		auto const str = Encode<char>(vecch32);
+		auto const str16 = Encode<tc::char16>(vecch32);
+		auto const str32 = tc::make_str<char32_t>(vecch32);
+		CheckConvertEnc(str, str16);
+		CheckConvertEnc(str, str32);
+		CheckConvertEnc(str16, str);
+		CheckConvertEnc(str16, str32);
+		CheckConvertEnc(str32, str);
+		CheckConvertEnc(str32, str16);
+	}
+}
+
+// Ill-formed input is replaced by U+FFFD after a notification, which the public build turns into an assertion.
+#ifdef TC_PRIVATE
+namespace {
+	template<typename Dst, typename Src>
+	void CheckConvertEncIllFormed(tc::string<Src> const& strSrc) noexcept {
+		auto const strDst = tc::make_str<Dst>(tc::convert_enc<Dst>(tc::transform(strSrc, tc::identity()))); // lazy conversion
+		_ASSERT(tc::equal(tc::make_str<Dst>(tc::convert_enc<Dst>(strSrc)), strDst)); // buffered transcoding of contiguous input
+		_ASSERTEQUAL(tc::size(tc::convert_enc<Dst>(strSrc)), tc::size(strDst));
+	}
+
+	template<typename Dst0, typename Dst1, typename Src>
+	void CheckConvertEncIllFormed(Src const* const strIllFormed) noexcept {
+		// Alone, and behind enough ASCII to go through the vectorized code paths and to fill a buffer.
+		for (auto const nPrefix : {0, 1, 63, 64, 600}) {
+			tc::string<Src> str;
+			tc::append(str, tc::repeat_n(nPrefix, tc::explicit_cast<Src>('a')), std::basic_string_view<Src>(strIllFormed), tc::repeat_n(3, tc::explicit_cast<Src>('z')));
+			CheckConvertEncIllFormed<Dst0>(str);
+			CheckConvertEncIllFormed<Dst1>(str);
+			tc::drop_last_inplace(str, 3);
+			CheckConvertEncIllFormed<Dst0>(str);
+			CheckConvertEncIllFormed<Dst1>(str);
+		}
+	}
+}
+
+UNITTESTDEF(convert_enc_ill_formed) {
+	for (auto const str : {"\x80", "\xBF\xBF", "\xC3", "\xE2\x82", "\xF0\x9F\x98", "\xC0\xAF", "\xE0\x80\xAF", "\xF0\x80\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xF8\x88\x80\x80\x80", "\xFE", "\xFF", "\xE2\x82\xC3\xA4"}) {
+		CheckConvertEncIllFormed<tc::char16, char32_t>(str);
+	}
+	for (auto const str : {u"\xD800", u"\xDBFF", u"\xDC00", u"\xDFFF\xD800", u"\xD800\xD800\xDC00", u"\xD800\x00E4"}) {
+		CheckConvertEncIllFormed<char, char32_t>(str);
+	}
+	for (auto const str : {U"\xD800", U"\xDFFF", U"\x110000", U"\xFFFFFFFF"}) {
+		CheckConvertEncIllFormed<char, tc::char16>(str);
+	}
+
+	_ASSERT(tc::equal(tc::make_str<char>(tc::convert_enc<char>(tc::make_str<tc::char16>(u"a\xD800z"))), "a�z"));
+	_ASSERT(tc::equal(tc::make_str<tc::char16>(tc::convert_enc<tc::char16>(tc::make_str<char32_t>(U"a\x110000z"))), u"a�z"));
+}
+#endif
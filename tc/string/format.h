@@ -17,59 +17,117 @@
 #include "../range/concat_adaptor.h"
 #include "../range/repeat_n.h"
 #include "char.h"
+#include "swar.h"
 
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated-declarations" // sprintf is deprecated in Xcode14.1 RC
-#endif
-#include <boost/lexical_cast.hpp>
-#ifdef __clang__
-#pragma clang diagnostic pop
-#endif
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
 
 namespace tc {
 	///////////////
 	// Wrapper to print integers as decimal
 
-	namespace integral_as_padded_dec_adl {
-		template< typename T, std::size_t N>
-		struct integral_as_padded_dec_impl;
+	namespace as_dec_detail {
+		// "00", "01", ..., "99": writing two digits per division halves the number of divisions.
+		inline constexpr auto c_achDigitPairs = []() noexcept {
+			std::array<tc::char_ascii, 200> ach{};
+			for (int i = 0; i < 100; ++i) {
+				ach[2 * i] = tc::char_ascii('0') + i / 10;
+				ach[2 * i + 1] = tc::char_ascii('0') + i % 10;
+			}
+			return ach;
+		}();
+
+		inline constexpr auto c_anPowerOfTen = []() noexcept {
+			std::array<std::uint64_t, 20> an{};
+			std::uint64_t n = 1;
+			for (auto& nPowerOfTen : an) {
+				nPowerOfTen = n;
+				n *= 10;
+			}
+			return an;
+		}();
+
+		// The number of decimal digits of n, 0 having one, without a loop: floor(log10(n)) is approximated from floor(log2(n)) + 1
+		// with 1233/4096 ~ log10(2), which is exact or one too small.
+		[[nodiscard]] constexpr int digit_count(std::uint64_t n) noexcept {
+			n |= 1;
+			int const nLog10 = (std::bit_width(n) * 1233) >> 12;
+			return nLog10 + (c_anPowerOfTen[nLog10] <= n);
+		}
 
-		template< typename T>
-		struct integral_as_padded_dec_impl<T,1>;
+		// Writes the nDigits decimal digits of n to [pch, pch + nDigits), two at a time from the back.
+		template<typename UInt>
+		constexpr void write_digits(tc::char_ascii* const pch, UInt n, int const nDigits) noexcept {
+			static_assert(std::is_unsigned<UInt>::value);
+			_ASSERTDEBUGEQUAL(digit_count(n), nDigits);
+			auto pchDigit = pch + nDigits;
+			while (100 <= n) {
+				auto const nPair = 2 * tc::explicit_cast<std::size_t>(n % 100);
+				n /= 100;
+				pchDigit -= 2;
+				pchDigit[0] = c_achDigitPairs[nPair];
+				pchDigit[1] = c_achDigitPairs[nPair + 1];
+			}
+			if (10 <= n) {
+				pchDigit -= 2;
+				pchDigit[0] = c_achDigitPairs[2 * n];
+				pchDigit[1] = c_achDigitPairs[2 * n + 1];
+			} else {
+				*--pchDigit = tc::char_ascii('0') + n;
+			}
+			_ASSERTDEBUGEQUAL(pchDigit, pch);
+		}
+	}
 
+	namespace integral_as_padded_dec_adl {
+		// Prints n with at least N digits. The digits are written into a buffer that is passed to the sink as a whole.
 		template< typename T, std::size_t N>
-		struct [[nodiscard]] integral_as_padded_dec_impl : protected integral_as_padded_dec_impl<T,N-1> {
+		struct [[nodiscard]] integral_as_padded_dec_impl final {
 			friend auto range_output_t_impl(integral_as_padded_dec_impl const&) -> tc::type::list<tc::char_ascii>; // declaration only
-			static constexpr unsigned long long c_nTenPow=integral_as_padded_dec_impl<T,N-1>::c_nTenPow*10;
-			constexpr integral_as_padded_dec_impl( T n ) noexcept : integral_as_padded_dec_impl<T,N-1>(n) {}
+		private:
+			static_assert( 0<N );
+			static_assert( sizeof(T)<=sizeof(std::uint64_t) );
+			// unsigned/signed char must be printed as number, not as character
+			using unsigned_t = std::conditional_t<sizeof(T)<=sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
 
-			template<typename Sink>
-			auto operator()(Sink sink) const& MAYTHROW -> tc::common_type_t<
-				decltype(tc::continue_if_not_break(std::declval<Sink&>(), std::declval<tc::char_ascii>())),
-				decltype(std::declval<integral_as_padded_dec_impl<T,N-1> const&>()(std::declval<Sink>()))
-			> {
-				static_assert( std::is_unsigned<T>::value );
-				if( this->m_n<integral_as_padded_dec_impl::c_nTenPow ) {
-					tc_yield(sink, tc::char_ascii('0'));
+			T m_n;
+
+			constexpr bool negative() const& noexcept {
+				if constexpr( std::is_signed<T>::value ) {
+					return m_n<0;
+				} else {
+					return false;
 				}
-				return tc::base_cast< integral_as_padded_dec_impl<T,N-1> >(*this)(tc_move(sink));
 			}
 
-			constexpr bool empty() const& noexcept { return false; }
-		};
+			constexpr unsigned_t magnitude() const& noexcept {
+				// Negating in the unsigned type is well-defined for std::numeric_limits<T>::lowest(), too.
+				return negative() ? 0-static_cast<unsigned_t>(m_n) : static_cast<unsigned_t>(m_n);
+			}
 
-		template< typename T>
-		struct [[nodiscard]] integral_as_padded_dec_impl<T,1> {
-			friend auto range_output_t_impl(integral_as_padded_dec_impl const&) -> tc::type::list<tc::char_ascii>; // declaration only
-			T m_n;
-			static constexpr unsigned long long c_nTenPow=1;
+		public:
 			constexpr integral_as_padded_dec_impl( T n ) noexcept : m_n(n) {}
 
 			template<typename Sink>
 			auto operator()(Sink&& sink) const& MAYTHROW {
-				tc_auto_cref(str, boost::lexical_cast< std::array<char,50> >(m_n+0/*force integral promotion, otherwise unsigned/signed char gets printed as character*/));
-				return tc::for_each(tc::transform(tc::ptr_begin(str), tc::fn_explicit_cast<tc::char_ascii>()), tc_move_if_owned(sink));
+				std::array<tc::char_ascii, tc::max(N, std::size_t(std::numeric_limits<unsigned_t>::digits10 + 1)) + 1> ach;
+				auto const nMagnitude = magnitude();
+				auto const nDigits = as_dec_detail::digit_count(nMagnitude);
+				auto pch = ach.data();
+				if( negative() ) {
+					*pch++ = tc::char_ascii('-');
+				}
+				if( tc::explicit_cast<std::size_t>(nDigits)<N ) {
+					pch = std::fill_n(pch, N-nDigits, tc::char_ascii('0'));
+				}
+				as_dec_detail::write_digits(pch, nMagnitude, nDigits);
+				return tc::for_each(tc::make_iterator_range(tc::as_const(ach).data(), tc::implicit_cast<tc::char_ascii const*>(pch + nDigits)), tc_move_if_owned(sink)); // MAYTHROW
+			}
+
+			constexpr std::size_t size() const& noexcept {
+				return tc::max(N, tc::explicit_cast<std::size_t>(as_dec_detail::digit_count(magnitude()))) + negative();
 			}
 
 			constexpr bool empty() const& noexcept { return false; }
@@ -98,6 +156,66 @@ namespace tc {
 		tc::as_padded_dec<N>(t.m_t)
 	)
 
+	///////////////
+	// Wrapper to print floating point numbers as decimal
+
+	namespace floating_point_as_dec_adl {
+		// Prints like std::to_chars, i.e., independent of the locale and without allocating: with nPrecision<0, the shortest representation that is parsed
+		// as the same value, in fixed or scientific notation, whichever is shorter; otherwise, in fixed notation with nPrecision digits after the decimal point.
+		template< typename T, int nPrecision>
+		struct [[nodiscard]] floating_point_as_dec_impl final {
+			friend auto range_output_t_impl(floating_point_as_dec_impl const&) -> tc::type::list<tc::char_ascii>; // declaration only
+		private:
+			static_assert( std::is_floating_point<T>::value );
+			// Digits of the largest decimal exponent, with room for subnormal numbers, whose exponents go up to max_digits10 below min_exponent10.
+			static constexpr std::size_t c_nExponentDigits = []() noexcept {
+				std::size_t nDigits = 1;
+				for( int n = std::numeric_limits<T>::max_exponent10 + std::numeric_limits<T>::max_digits10; 10 <= n; n /= 10 ) ++nDigits;
+				return nDigits;
+			}();
+			// sign, digits, decimal point and, for the shortest representation, exponent, e.g., -2.2250738585072014e-308
+			static constexpr std::size_t c_nMaxSize = nPrecision<0
+				? 1 + std::numeric_limits<T>::max_digits10 + 1 + 2 + c_nExponentDigits
+				: 1 + (std::numeric_limits<T>::max_exponent10 + 1) + 1 + nPrecision;
+
+			T m_t;
+
+		public:
+			constexpr floating_point_as_dec_impl( T t ) noexcept : m_t(t) {}
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				std::array<char, c_nMaxSize> ach;
+				auto const result = [&]() noexcept {
+					if constexpr( nPrecision<0 ) {
+						return std::to_chars(ach.data(), tc::end(ach), m_t);
+					} else {
+						return std::to_chars(ach.data(), tc::end(ach), m_t, std::chars_format::fixed, nPrecision);
+					}
+				}();
+				_ASSERTEQUAL(result.ec, std::errc());
+				// Hand the sink a single contiguous chunk, like as_dec does for integers.
+				std::array<tc::char_ascii, c_nMaxSize> achAscii;
+				auto const pchEnd = std::transform(tc::as_const(ach).data(), tc::implicit_cast<char const*>(result.ptr), achAscii.data(), tc::fn_explicit_cast<tc::char_ascii>());
+				return tc::for_each(tc::make_iterator_range(tc::as_const(achAscii).data(), tc::implicit_cast<tc::char_ascii const*>(pchEnd)), tc_move_if_owned(sink)); // MAYTHROW
+			}
+
+			constexpr bool empty() const& noexcept { return false; }
+		};
+	}
+
+	template< std::floating_point T>
+	constexpr auto as_dec(T t) return_ctor_noexcept(
+		TC_FWD(floating_point_as_dec_adl::floating_point_as_dec_impl<T, -1>),
+		(t)
+	)
+
+	template< int nPrecision, std::floating_point T>
+	constexpr auto as_fixed_dec(T t) return_ctor_noexcept(
+		TC_FWD(floating_point_as_dec_adl::floating_point_as_dec_impl<T, nPrecision>),
+		(t)
+	)
+
 	TC_DEFINE_ENUM(casing, BOOST_PP_EMPTY(), (uppercase)(lowercase));
 
 	namespace as_hex_adl {
@@ -159,10 +277,35 @@ namespace tc {
 	//////////////////////////////////////////////////
 	// conversion from string to number
 
+	namespace integer_from_string_detail {
+		// Consumes blocks of 8 digits at once, as long as they fit into T. The remaining digits, and a block that would overflow, are left to digit-wise parsing,
+		// which determines exactly where parsing stops.
+		template< bool bNegative, typename T, typename It >
+		void eight_digits_head(T& n, It& it, It const itEnd) noexcept {
+			if constexpr( tc::actual_integer<T> && sizeof(T)<=sizeof(std::uint64_t) && tc::swar_detail::c_bSwar<It> ) {
+				// Magnitudes are accumulated unsigned, so that the check for overflow is the same for both signs.
+				static constexpr std::uint64_t c_nMax = bNegative
+					? 0-static_cast<std::uint64_t>(std::numeric_limits<T>::lowest())
+					: static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+				std::uint64_t nMagnitude = bNegative ? 0-static_cast<std::uint64_t>(n) : static_cast<std::uint64_t>(n);
+				while( 8<=itEnd-it ) {
+					auto const nChars = tc::swar_detail::load_eight_chars(it);
+					if( !tc::swar_detail::is_eight_digits(nChars) ) break;
+					auto const nBlock = tc::swar_detail::eight_digits_value(nChars);
+					if( c_nMax<nBlock || (c_nMax-nBlock)/100000000<nMagnitude ) break; // overflow
+					nMagnitude = nMagnitude*100000000+nBlock;
+					it += 8;
+				}
+				n = static_cast<T>(bNegative ? 0-nMagnitude : nMagnitude);
+			}
+		}
+	}
+
 	template< typename T, typename Rng >
 	auto unsigned_integer_from_string_head(Rng&& rng) noexcept {
 		auto pairnit=std::make_pair(tc::explicit_cast<T>(0),tc::begin(rng));
 		auto const itEnd=tc::end(rng);
+		integer_from_string_detail::eight_digits_head</*bNegative*/false>(pairnit.first, pairnit.second, itEnd);
 		while( pairnit.second!=itEnd ) {
 			unsigned int const nDigit=*pairnit.second-tc::explicit_cast<tc::range_value_t<Rng&>>('0');
 			if( 9<nDigit || (std::numeric_limits<T>::max()-static_cast<int>(nDigit))/10<pairnit.first ) break; // overflow
@@ -182,6 +325,7 @@ MODIFY_WARNINGS_END
 		if( pairnit.second!=itEnd ) {
 			if (tc::explicit_cast<tc::range_value_t<Rng&>>('-') == *pairnit.second) {
 				++pairnit.second;
+				integer_from_string_detail::eight_digits_head</*bNegative*/true>(pairnit.first, pairnit.second, itEnd);
 				while (pairnit.second != itEnd) {
 					unsigned int const nDigit = *pairnit.second - tc::explicit_cast<tc::range_value_t<Rng&>>('0');
 					if (9 < nDigit || pairnit.first < (std::numeric_limits<T>::lowest() + static_cast<int>(nDigit)) / 10) break; // underflow
@@ -0,0 +1,158 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "format.h"
+#include "../algorithm/append.h"
+#include "../container/insert.h"
+#include "../range/transform_adaptor.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+
+namespace {
+	template<typename T>
+	void CheckAsDec(T const n) noexcept {
+		auto const str = tc::make_str<char>(tc::as_dec(n));
+		_ASSERT(tc::equal(str, std::to_string(n)));
+		_ASSERTEQUAL(tc::size(tc::as_dec(n)), tc::size(str));
+	}
+}
+
+UNITTESTDEF(as_dec) {
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(0)), "0"));
+	_ASSERTEQUAL(tc::as_dec_detail::digit_count(0), 1);
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(tc::explicit_cast<signed char>(-128))), "-128"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(tc::explicit_cast<unsigned char>(255))), "255"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(std::numeric_limits<std::int64_t>::lowest())), "-9223372036854775808"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(std::numeric_limits<std::uint64_t>::max())), "18446744073709551615"));
+	_ASSERT(tc::equal(tc::make_str<tc::char16>(tc::as_dec(-42)), u"-42"));
+
+	// Every number of digits, and its neighbors at the powers of ten.
+	for (std::uint64_t n = 1; n <= std::numeric_limits<std::uint64_t>::max() / 10; n *= 10) {
+		CheckAsDec(n - 1);
+		CheckAsDec(n);
+		CheckAsDec(n * 10 - 1);
+		CheckAsDec(-tc::explicit_cast<std::int64_t>(n));
+	}
+	std::mt19937_64 gen(42);
+	for (int i = 0; i < 10000; ++i) {
+		auto const n = gen() >> std::uniform_int_distribution<int>(0, 63)(gen);
+		CheckAsDec(n);
+		CheckAsDec(tc::explicit_cast<std::int64_t>(n));
+		CheckAsDec(static_cast<std::int32_t>(n));
+		CheckAsDec(static_cast<std::uint16_t>(n));
+	}
+}
+
+UNITTESTDEF(as_padded_dec) {
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_padded_dec<1>(0)), "0"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_padded_dec<3>(7)), "007"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_padded_dec<3>(1234)), "1234"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_padded_dec<25>(std::numeric_limits<std::uint64_t>::max())), "0000018446744073709551615"));
+	_ASSERTEQUAL(tc::size(tc::as_padded_dec<4>(12)), 4);
+	_ASSERTEQUAL(tc::size(tc::as_padded_dec<2>(12345)), 5);
+
+	tc::string<char> str;
+	tc::append(str, tc::as_padded_dec<4>(2023), "-", tc::as_padded_dec<2>(1), "-", tc::as_padded_dec<2>(9));
+	_ASSERT(tc::equal(str, "2023-01-09"));
+}
+
+UNITTESTDEF(as_dec_floating_point) {
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(0.0)), "0"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(-0.0)), "-0"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(0.1)), "0.1"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(1e300)), "1e+300"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(0.1f)), "0.1"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(-std::numeric_limits<double>::denorm_min())), "-5e-324"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(std::numeric_limits<double>::infinity())), "inf"));
+	_ASSERT(tc::equal(tc::make_str<tc::char16>(tc::concat("x=", tc::as_dec(2.5), ";")), u"x=2.5;"));
+	if constexpr( 4932 == std::numeric_limits<long double>::max_exponent10 ) { // x87 extended precision
+		_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(-1.03671758961202947406e-4807L)), "-1.03671758961202947406e-4807"));
+		_ASSERT(tc::equal(tc::make_str<char>(tc::as_dec(-std::numeric_limits<long double>::denorm_min())), "-4e-4951"));
+	}
+
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_fixed_dec<2>(3.14159)), "3.14"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_fixed_dec<3>(-2.0)), "-2.000"));
+	_ASSERT(tc::equal(tc::make_str<char>(tc::as_fixed_dec<0>(0.5)), "0")); // rounds to even
+	_ASSERTEQUAL(tc::size(tc::make_str<char>(tc::as_fixed_dec<1>(-std::numeric_limits<double>::max()))), 1 + 309 + 2);
+
+	// Shortest round trip of random bit patterns, including subnormals.
+	std::mt19937_64 gen(42);
+	for (int i = 0; i < 10000; ++i) {
+		auto const f = tc::bit_cast<double>(gen());
+		if (!std::isfinite(f)) continue;
+		auto const str = tc::make_str<char>(tc::as_dec(f));
+		double fParsed;
+		_ASSERTEQUAL(std::from_chars(tc::ptr_begin(str), tc::ptr_end(str), fParsed).ptr, tc::ptr_end(str));
+		_ASSERTEQUAL(tc::bit_cast<std::uint64_t>(fParsed), tc::bit_cast<std::uint64_t>(f));
+	}
+}
+
+namespace {
+	// Compares parsing contiguous input, which consumes 8 digits at once, with digit-wise parsing of the same characters.
+	template<typename T>
+	void CheckIntegerFromString(tc::string<char> const& str) noexcept {
+		auto const rngNotContiguous = tc::transform(str, tc::identity());
+		auto const pairnit = tc::signed_integer_from_string_head<T>(str);
+		auto const pairnitNotContiguous = tc::signed_integer_from_string_head<T>(rngNotContiguous);
+		_ASSERTEQUAL(pairnit.first, pairnitNotContiguous.first);
+		_ASSERTEQUAL(pairnit.second - tc::begin(str), pairnitNotContiguous.second - tc::begin(rngNotContiguous));
+		if constexpr (std::is_unsigned<T>::value) {
+			auto const pairnitUnsigned = tc::unsigned_integer_from_string_head<T>(str);
+			auto const pairnitUnsignedNotContiguous = tc::unsigned_integer_from_string_head<T>(rngNotContiguous);
+			_ASSERTEQUAL(pairnitUnsigned.first, pairnitUnsignedNotContiguous.first);
+			_ASSERTEQUAL(pairnitUnsigned.second - tc::begin(str), pairnitUnsignedNotContiguous.second - tc::begin(rngNotContiguous));
+		}
+	}
+}
+
+UNITTESTDEF(integer_from_string) {
+	_ASSERTEQUAL(tc::unsigned_integer_from_string<std::uint64_t>(tc::make_str("18446744073709551615")), std::numeric_limits<std::uint64_t>::max());
+	_ASSERTEQUAL(tc::signed_integer_from_string<std::int64_t>(tc::make_str("-9223372036854775808")), std::numeric_limits<std::int64_t>::lowest());
+	_ASSERTEQUAL(tc::signed_integer_from_string<std::int32_t>(tc::make_str("+0000000000000000000123")), 123);
+	{
+		auto const str = tc::make_str("1844674407370955161599");
+		auto const pairnit = tc::unsigned_integer_from_string_head<std::uint64_t>(str);
+		_ASSERTEQUAL(pairnit.first, std::numeric_limits<std::uint64_t>::max());
+		_ASSERTEQUAL(pairnit.second - tc::begin(str), 20); // stops at the digit that would overflow
+	}
+	auto const Throws = [](auto const& str) noexcept {
+		try {
+			tc::signed_integer_from_string<std::int32_t>(str);
+		} catch (tc::integer_parse_exception const&) {
+			return true;
+		}
+		return false;
+	};
+	_ASSERT(Throws(tc::make_str("")));
+	_ASSERT(Throws(tc::make_str("123456789x")));
+	_ASSERT(Throws(tc::make_str("2147483648")));
+	_ASSERT(!Throws(tc::make_str("-2147483648")));
+
+	std::mt19937_64 gen(42);
+	for (int i = 0; i < 10000; ++i) {
+		tc::string<char> str;
+		switch (std::uniform_int_distribution<int>(0, 2)(gen)) {
+		case 0: tc::cont_emplace_back(str, '-'); break;
+		case 1: tc::cont_emplace_back(str, '+'); break;
+		default: break;
+		}
+		auto const n = std::uniform_int_distribution<int>(0, 30)(gen);
+		for (int j = 0; j < n; ++j) {
+			tc::cont_emplace_back(str, "0123456789999999x"[std::uniform_int_distribution<int>(0, j < 20 ? 15 : 16)(gen)]);
+		}
+		CheckIntegerFromString<std::int8_t>(str);
+		CheckIntegerFromString<std::uint16_t>(str);
+		CheckIntegerFromString<std::int32_t>(str);
+		CheckIntegerFromString<std::uint32_t>(str);
+		CheckIntegerFromString<std::int64_t>(str);
+		CheckIntegerFromString<std::uint64_t>(str);
+	}
+}
@@ -0,0 +1,256 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "jsonparser.h"
+#include "../base/reference_or_value.h"
+#include "../container/insert.h"
+
+namespace tc::json {
+	TC_DEFINE_ENUM(EValueKind, evaluekind, (NULLVALUE)(BOOLEAN)(NUMBER)(STRING)(ARRAY)(OBJECT))
+
+	namespace no_adl {
+		// One entry per value and per object key, in document order. The members of an object alternate between key and value.
+		struct tape_entry final {
+			EValueKind m_evaluekind;
+			std::uint32_t m_nBegin; // offset of the first character, for strings after the opening quote
+			std::uint32_t m_nEnd; // offset after the last character, for strings of the closing quote
+			std::uint32_t m_iNext; // index of the next entry after this value and all of its children
+		};
+
+		template<typename Document>
+		struct [[nodiscard]] value final {
+			explicit value(Document const& doc, std::uint32_t const i) noexcept
+				: m_pdoc(std::addressof(doc))
+				, m_i(i)
+			{}
+
+			EValueKind kind() const& noexcept {
+				return entry().m_evaluekind;
+			}
+
+			// The value as it appears in the input, for strings without the quotes.
+			auto raw() const& noexcept {
+				auto const itchBegin = tc::begin(m_pdoc->input());
+				return tc::slice(m_pdoc->input(), itchBegin + entry().m_nBegin, itchBegin + entry().m_nEnd);
+			}
+
+			bool is_null() const& noexcept {
+				return evaluekindNULLVALUE == kind();
+			}
+
+			std::optional<bool> boolean() const& noexcept {
+				if (evaluekindBOOLEAN != kind()) return std::nullopt;
+				return 4 == entry().m_nEnd - entry().m_nBegin; // "true" or "false"
+			}
+
+			template<typename T>
+			std::optional<T> number() const& noexcept {
+				if (evaluekindNUMBER != kind()) return std::nullopt;
+				return tc::number_from_json_string<T>(raw());
+			}
+
+			// Zero-copy: the decoded string is computed on iteration.
+			auto string() const& noexcept {
+				using Result = std::optional<decltype(tc::json::decode(raw()))>;
+				if (evaluekindSTRING != kind()) return Result();
+				return Result(tc::json::decode(raw()));
+			}
+
+			// Number of elements of an array or members of an object.
+			std::size_t size() const& noexcept {
+				_ASSERT(evaluekindARRAY == kind() || evaluekindOBJECT == kind());
+				std::size_t n = 0;
+				for (auto i = m_i + 1; i != entry().m_iNext; i = m_pdoc->m_vecentry[i].m_iNext) ++n;
+				return evaluekindOBJECT == kind() ? n / 2 : n;
+			}
+
+			// Children are skipped in O(1) each, without looking at the input.
+			std::optional<value> element(std::size_t n) const& noexcept {
+				if (evaluekindARRAY != kind()) return std::nullopt;
+				for (auto i = m_i + 1; i != entry().m_iNext; i = m_pdoc->m_vecentry[i].m_iNext) {
+					if (0 == n--) return value(*m_pdoc, i);
+				}
+				return std::nullopt;
+			}
+
+			template<typename Key>
+			std::optional<value> member(Key const& key) const& MAYTHROW {
+				if (evaluekindOBJECT != kind()) return std::nullopt;
+				for (auto i = m_i + 1; i != entry().m_iNext; i = m_pdoc->m_vecentry[i + 1].m_iNext) {
+					if (tc::equal(*value(*m_pdoc, i).string(), key)) return value(*m_pdoc, i + 1); // MAYTHROW
+				}
+				return std::nullopt;
+			}
+
+			// JSON pointer as in https://www.rfc-editor.org/rfc/rfc6901, e.g., "/a/0/b~1c" for the member "b/c" of the first element of the member "a".
+			template<typename Pointer>
+			std::optional<value> at_pointer(Pointer const& pointer) const& MAYTHROW {
+				using char_type = tc::range_value_t<Pointer const&>;
+				std::optional<value> ovalue(*this);
+				auto it = tc::begin(pointer);
+				auto const itEnd = tc::end(pointer);
+				if (it == itEnd) return ovalue;
+				if (tc::explicit_cast<char_type>('/') != *it) return std::nullopt;
+				tc::string<char_type> strToken;
+				while (it != itEnd && ovalue) {
+					++it; // '/'
+					strToken.clear();
+					for (; it != itEnd && tc::explicit_cast<char_type>('/') != *it; ++it) {
+						if (tc::explicit_cast<char_type>('~') == *it) {
+							if (++it == itEnd) return std::nullopt;
+							if (tc::explicit_cast<char_type>('0') == *it) {
+								tc::cont_emplace_back(strToken, tc::explicit_cast<char_type>('~'));
+							} else if (tc::explicit_cast<char_type>('1') == *it) {
+								tc::cont_emplace_back(strToken, tc::explicit_cast<char_type>('/'));
+							} else {
+								return std::nullopt;
+							}
+						} else {
+							tc::cont_emplace_back(strToken, *it);
+						}
+					}
+
+					if (evaluekindARRAY == ovalue->kind()) {
+						// Array indices are decimal numbers without leading zeros.
+						if (tc::empty(strToken) || (1 < tc::size(strToken) && tc::explicit_cast<char_type>('0') == tc::front(strToken))) return std::nullopt;
+						std::size_t n = 0;
+						for (auto const ch : strToken) {
+							auto const nDigit = static_cast<unsigned int>(ch) - static_cast<unsigned int>('0');
+							if (9 < nDigit || (std::numeric_limits<std::size_t>::max() - nDigit) / 10 < n) return std::nullopt;
+							n = n * 10 + nDigit;
+						}
+						ovalue = ovalue->element(n);
+					} else {
+						ovalue = ovalue->member(strToken); // MAYTHROW
+					}
+				}
+				return ovalue;
+			}
+
+			// Generates the elements of an array.
+			auto elements() const& noexcept {
+				_ASSERT(evaluekindARRAY == kind());
+				return tc::generator_range_output<value>([self = *this](auto sink) MAYTHROW
+					-> tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<value>())), tc::constant<tc::continue_>>
+				{
+					for (auto i = self.m_i + 1; i != self.entry().m_iNext; i = self.m_pdoc->m_vecentry[i].m_iNext) {
+						tc_return_if_break(tc::continue_if_not_break(sink, value(*self.m_pdoc, i))); // MAYTHROW
+					}
+					return tc::constant<tc::continue_>();
+				});
+			}
+
+			// Generates the members of an object as pairs of key and value.
+			auto members() const& noexcept {
+				_ASSERT(evaluekindOBJECT == kind());
+				using member_t = std::pair<decltype(*string()), value>;
+				return tc::generator_range_output<member_t>([self = *this](auto sink) MAYTHROW
+					-> tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<member_t>())), tc::constant<tc::continue_>>
+				{
+					for (auto i = self.m_i + 1; i != self.entry().m_iNext; i = self.m_pdoc->m_vecentry[i + 1].m_iNext) {
+						tc_return_if_break(tc::continue_if_not_break(sink, member_t(*value(*self.m_pdoc, i).string(), value(*self.m_pdoc, i + 1)))); // MAYTHROW
+					}
+					return tc::constant<tc::continue_>();
+				});
+			}
+
+		private:
+			tape_entry const& entry() const& noexcept {
+				return m_pdoc->m_vecentry[m_i];
+			}
+
+			Document const* m_pdoc;
+			std::uint32_t m_i;
+		};
+
+		// Parses and validates the whole input once and records every value on a tape, which then allows random access without parsing again.
+		// The tape stores 32-bit offsets, so inputs of 4 GiB or more are reported as semantic_error. Every value takes at least one character, so the tape indices fit, too.
+		template<typename String>
+		struct [[nodiscard]] document final : tc::noncopyable {
+			template<typename ErrorHandler>
+			explicit document(String&& strInput, ErrorHandler errorhandler) MAYTHROW
+				: m_strInput(tc::aggregate_tag, tc_move_if_owned(strInput))
+			{
+				auto const itchBegin = tc::begin(input());
+				auto const offset = [&](auto const it) noexcept {
+					return tc::explicit_cast<std::uint32_t>(it - itchBegin);
+				};
+				auto const append_entry = [&](EValueKind const evaluekind, std::uint32_t const nBegin, std::uint32_t const nEnd) noexcept {
+					auto const i = tc::explicit_cast<std::uint32_t>(tc::size(m_vecentry));
+					tc::cont_emplace_back(m_vecentry, tape_entry{evaluekind, nBegin, nEnd, i + 1});
+				};
+
+				tc::json::parser parser(input(), tc_move(errorhandler));
+				if (std::numeric_limits<std::uint32_t>::max() <= tc::size(input())) parser.semantic_error(); // MAYTHROW
+				tc::vector<std::uint32_t> veciOpen; // tape indices of the arrays and objects that are not closed yet
+				for (;;) {
+					// Any value.
+					auto const itchValue = parser.position();
+					if (parser.null()) { // MAYTHROW
+						append_entry(evaluekindNULLVALUE, offset(itchValue), offset(itchValue) + 4);
+					} else if (auto const ob = parser.boolean()) { // MAYTHROW
+						append_entry(evaluekindBOOLEAN, offset(itchValue), offset(itchValue) + (*ob ? 4 : 5));
+					} else if (auto const ostr = parser.number()) { // MAYTHROW
+						append_entry(evaluekindNUMBER, offset(tc::begin(*ostr)), offset(tc::end(*ostr)));
+					} else if (auto const ostr = parser.string()) { // MAYTHROW
+						append_entry(evaluekindSTRING, offset(tc::begin(ostr->base_range())), offset(tc::end(ostr->base_range())));
+					} else if (parser.array()) { // MAYTHROW
+						tc::cont_emplace_back(veciOpen, tc::explicit_cast<std::uint32_t>(tc::size(m_vecentry)));
+						append_entry(evaluekindARRAY, offset(itchValue), 0);
+					} else if (parser.object()) { // MAYTHROW
+						tc::cont_emplace_back(veciOpen, tc::explicit_cast<std::uint32_t>(tc::size(m_vecentry)));
+						append_entry(evaluekindOBJECT, offset(itchValue), 0);
+					} else {
+						parser.skip_value(); // MAYTHROW, reports value_expected
+						_ASSERTFALSE;
+					}
+
+					// Continue with the next element or member, or close the innermost array or object.
+					for (;;) {
+						if (tc::empty(veciOpen)) {
+							parser.expect_end(); // MAYTHROW
+							return;
+						}
+						auto& entryOpen = m_vecentry[tc::back(veciOpen)];
+						auto const itchNext = parser.position();
+						if (evaluekindARRAY == entryOpen.m_evaluekind) {
+							if (parser.element()) break; // MAYTHROW
+						} else if (auto const ostrKey = parser.key()) { // MAYTHROW
+							append_entry(evaluekindSTRING, offset(tc::begin(ostrKey->base_range())), offset(tc::end(ostrKey->base_range())));
+							break;
+						}
+						// Note that entryOpen is still valid, the closing bracket added no entry.
+						entryOpen.m_nEnd = offset(itchNext) + 1;
+						entryOpen.m_iNext = tc::explicit_cast<std::uint32_t>(tc::size(m_vecentry));
+						tc::drop_last_inplace(veciOpen);
+					}
+				}
+			}
+
+			decltype(auto) input() const& noexcept {
+				return *m_strInput;
+			}
+
+			auto root() const& noexcept {
+				return value<document>(*this, 0);
+			}
+
+		private:
+			friend struct value<document>;
+
+			tc::reference_or_value<String> m_strInput;
+			tc::vector<tape_entry> m_vecentry;
+		};
+
+		template<typename String, typename ErrorHandler>
+		document(String&&, ErrorHandler) -> document<String>;
+	}
+	using no_adl::document;
+}
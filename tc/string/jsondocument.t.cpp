@@ -0,0 +1,78 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "jsondocument.h"
+
+UNITTESTDEF(JSONDocument) {
+	tc::json::document const doc(
+		tc::make_str(R"( {"a": [1, -2.5, "x\"y", null, true, false, {}, []], "b~/c": {"d": {"e": "€"}}, "": 7 } )"),
+		tc::json::simple_error_handler(tc::never_called())
+	);
+	auto const root = doc.root();
+	_ASSERTEQUAL(root.kind(), tc::json::evaluekindOBJECT);
+	_ASSERTEQUAL(root.size(), 3);
+
+	auto const a = *root.member("a");
+	_ASSERTEQUAL(a.size(), 8);
+	_ASSERTEQUAL(*a.element(0)->number<int>(), 1);
+	_ASSERTEQUAL(*a.element(1)->number<double>(), -2.5);
+	_ASSERT(!a.element(1)->number<int>());
+	_ASSERT(tc::equal(*a.element(2)->string(), "x\"y"));
+	_ASSERT(tc::equal(a.element(2)->raw(), "x\\\"y"));
+	_ASSERT(a.element(3)->is_null());
+	_ASSERTEQUAL(*a.element(4)->boolean(), true);
+	_ASSERTEQUAL(*a.element(5)->boolean(), false);
+	_ASSERTEQUAL(a.element(6)->size(), 0);
+	_ASSERT(tc::equal(a.element(6)->raw(), "{}"));
+	_ASSERTEQUAL(a.element(7)->size(), 0);
+	_ASSERT(!a.element(8));
+	_ASSERT(!a.member("a"));
+
+	static tc::json::EValueKind const c_aevaluekind[] = {
+		tc::json::evaluekindNUMBER, tc::json::evaluekindNUMBER, tc::json::evaluekindSTRING, tc::json::evaluekindNULLVALUE,
+		tc::json::evaluekindBOOLEAN, tc::json::evaluekindBOOLEAN, tc::json::evaluekindOBJECT, tc::json::evaluekindARRAY
+	};
+	int n = 0;
+	tc::for_each(a.elements(), [&](auto const value) noexcept {
+		_ASSERTEQUAL(value.kind(), c_aevaluekind[n]);
+		++n;
+	});
+	_ASSERTEQUAL(n, 8);
+	static char const* const c_aszKey[] = {"a", "b~/c", ""};
+	n = 0;
+	tc::for_each(root.members(), [&](auto const& member) noexcept {
+		_ASSERT(tc::equal(member.first, c_aszKey[n]));
+		++n;
+	});
+	_ASSERTEQUAL(n, 3);
+
+	_ASSERT(tc::equal(*root.at_pointer("/b~0~1c/d/e")->string(), "€"));
+	_ASSERTEQUAL(*root.at_pointer("/a/1")->number<double>(), -2.5);
+	_ASSERTEQUAL(*root.at_pointer("/")->number<int>(), 7);
+	_ASSERTEQUAL(root.at_pointer("")->kind(), tc::json::evaluekindOBJECT);
+	_ASSERT(!root.at_pointer("/a/01"));
+	_ASSERT(!root.at_pointer("/a/8"));
+	_ASSERT(!root.at_pointer("/a/-"));
+	_ASSERT(!root.at_pointer("/b~/c"));
+	_ASSERT(!root.at_pointer("a"));
+
+	tc::json::document const docScalar(tc::make_str("\"abc\""), tc::json::simple_error_handler(tc::never_called()));
+	_ASSERT(tc::equal(*docScalar.root().string(), "abc"));
+
+	struct ExFailure final {};
+	for (auto const sz : {"[1,]", "{\"a\" 1}", "[1", "1 2", "{\"a\":}", "[nul]"}) {
+		try {
+			tc::json::document doc(tc::make_str(sz), tc::json::simple_error_handler([](tc::unused) THROW(ExFailure) {
+				throw ExFailure();
+			}));
+			_ASSERTFALSE;
+		} catch (ExFailure const&) {
+		}
+	}
+}
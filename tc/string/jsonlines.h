@@ -0,0 +1,68 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "jsonparser.h"
+#include "../algorithm/for_each_batch_parallel.h"
+#include "../container/insert.h"
+
+namespace tc::json {
+	using tc::unordered_tag_t;
+	using tc::unordered_tag;
+
+	namespace for_each_line_parallel_detail {
+		// Large enough to make the synchronization per batch negligible, small enough to balance the load between threads.
+		inline constexpr std::size_t c_nBatchSize = 1 << 18;
+
+		template<typename Char>
+		Char const* line_end(Char const* const pch, Char const* const pchEnd) noexcept {
+			return tc::simd::find_first_of<tc::simd::any_of<'\n'>>(pch, pchEnd);
+		}
+	}
+
+	// Parses newline-delimited JSON (https://jsonlines.org/) on all cores. The input is cut into batches at line breaks, and every line that is not blank
+	// is parsed by its own tc::json::parser, which is passed to func. func must consume exactly one value. func and the copies of errorhandler are called concurrently.
+	// The results of func are passed to sink on the calling thread, in input order, or with unordered_tag in the order in which the batches are done.
+	// An exception thrown by func or errorhandler stops the parsing and is rethrown on the calling thread.
+	template<typename Rng, typename ErrorHandler, typename Func, typename Sink, typename... Tag>
+	auto for_each_line_parallel(Rng const& rng, ErrorHandler const& errorhandler, Func const& func, Sink&& sink, Tag... tag) MAYTHROW {
+		static_assert(tc::contiguous_range<Rng const&> && 1 == sizeof(tc::range_value_t<Rng const&>));
+		using namespace for_each_line_parallel_detail;
+
+		auto const pchBegin = tc::ptr_begin(rng);
+		auto const pchEnd = pchBegin + tc::size(rng);
+		using line_t = decltype(tc::make_iterator_range(pchBegin, pchEnd));
+		using result_t = decltype(func(std::declval<tc::json::parser<line_t, ErrorHandler>&>()));
+		static_assert(!std::is_void<result_t>::value);
+
+		// Batch i starts after the line break at or after the offset i * c_nBatchSize. Batches may be empty if lines are long.
+		auto const nBatches = (tc::size(rng) + c_nBatchSize - 1) / c_nBatchSize;
+		auto const batch_begin = [&](std::size_t const iBatch) noexcept {
+			if (0 == iBatch) return pchBegin;
+			if (nBatches == iBatch) return pchEnd;
+			auto const pch = line_end(pchBegin + iBatch * c_nBatchSize, pchEnd);
+			return pch == pchEnd ? pchEnd : pch + 1;
+		};
+
+		return tc::for_each_batch_parallel(nBatches, [&](std::size_t const iBatch) MAYTHROW {
+			tc::vector<result_t> vecresult;
+			auto const pchBatchEnd = batch_begin(iBatch + 1);
+			for (auto pchLine = batch_begin(iBatch); pchLine != pchBatchEnd;) {
+				auto const pchLineEnd = line_end(pchLine, pchBatchEnd);
+				if (tc::simd::find_first_not_of<tc::simd::any_of<'\t', '\n', '\r', ' '>>(pchLine, pchLineEnd) != pchLineEnd) {
+					tc::json::parser parser(tc::make_iterator_range(pchLine, pchLineEnd), errorhandler); // MAYTHROW
+					tc::cont_emplace_back(vecresult, func(parser)); // MAYTHROW
+					parser.expect_end(); // MAYTHROW
+				}
+				pchLine = pchLineEnd == pchBatchEnd ? pchBatchEnd : pchLineEnd + 1;
+			}
+			return vecresult;
+		}, tc_move_if_owned(sink), tag...); // MAYTHROW
+	}
+}
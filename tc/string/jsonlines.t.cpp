@@ -0,0 +1,86 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "jsonlines.h"
+#include "../algorithm/append.h"
+#include "../algorithm/algorithm.h"
+#include "format.h"
+
+namespace {
+	struct ExFailure final {};
+
+	auto const c_errorhandler = tc::json::simple_error_handler([](tc::unused) THROW(ExFailure) {
+		throw ExFailure();
+	});
+
+	int ParseRecord(auto& parser) MAYTHROW {
+		parser.expect_object();
+		auto const ostrKey = parser.key();
+		_ASSERT(ostrKey && tc::equal(*ostrKey, "i"));
+		auto const n = parser.template expect_number<int>();
+		while (auto const ostr = parser.key()) parser.skip_value();
+		return n;
+	}
+}
+
+UNITTESTDEF(JSONForEachLineParallel) {
+	// Spans several batches, with blank lines, CRLF and a missing line break at the end.
+	tc::string<char> str;
+	int const nRecords = 100000;
+	for (int i = 0; i < nRecords; ++i) {
+		tc::append(str, R"({"i": )", tc::as_dec(i), R"(, "s": "some text \" with an escaped quote"})", 0 == i % 7 ? "\r\n\n  \n" : "\n");
+	}
+	tc::append(str, R"({"i": )", tc::as_dec(nRecords), "}");
+
+	{
+		tc::vector<int> vecn;
+		tc::json::for_each_line_parallel(str, c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [&](int const n) noexcept {
+			tc::cont_emplace_back(vecn, n);
+		});
+		_ASSERT(tc::equal(vecn, tc::iota(0, nRecords + 1)));
+	}
+	{
+		tc::vector<int> vecn;
+		tc::json::for_each_line_parallel(str, c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [&](int const n) noexcept {
+			tc::cont_emplace_back(vecn, n);
+		}, tc::json::unordered_tag);
+		tc::sort_inplace(vecn);
+		_ASSERT(tc::equal(vecn, tc::iota(0, nRecords + 1)));
+	}
+	{
+		int nSunk = 0;
+		_ASSERTEQUAL(tc::break_, tc::json::for_each_line_parallel(str, c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [&](int const n) noexcept {
+			_ASSERTEQUAL(n, nSunk);
+			return 1000 == ++nSunk ? tc::break_ : tc::continue_;
+		}));
+		_ASSERTEQUAL(nSunk, 1000);
+	}
+	{
+		// Two values on one line.
+		auto strInvalid = str;
+		tc::append(strInvalid, "\n{\"i\": 0} {}\n");
+		tc::for_each(tc::make_array(tc::aggregate_tag, false, true), [&](bool const bUnordered) noexcept {
+			try {
+				auto const sink = [](int) noexcept {};
+				auto const func = [](auto& parser) MAYTHROW { return ParseRecord(parser); };
+				if (bUnordered) {
+					tc::json::for_each_line_parallel(strInvalid, c_errorhandler, func, sink, tc::json::unordered_tag); // THROW(ExFailure)
+				} else {
+					tc::json::for_each_line_parallel(strInvalid, c_errorhandler, func, sink); // THROW(ExFailure)
+				}
+				_ASSERTFALSE;
+			} catch (ExFailure const&) {}
+		});
+	}
+	{
+		int nSunk = 0;
+		tc::json::for_each_line_parallel(tc::make_str(""), c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [&](int) noexcept { ++nSunk; });
+		_ASSERTEQUAL(nSunk, 0);
+	}
+}
@@ -13,21 +13,10 @@
 #include "named.h"
 #include "spirit_algorithm.h"
 #include "parserbase.h"
+#include "simd.h"
+#include "parse_number.h"
 
-#include <boost/predef/architecture.h>
-#if BOOST_ARCH_X86
-# define TC_JSON_SIMD 1
-# include <emmintrin.h>
-#elif BOOST_ARCH_ARM
-# define TC_JSON_SIMD 1
-# ifdef TC_WIN
-#  include <arm64_neon.h> // https://developercommunity.visualstudio.com/t/ARM64EC-should-be-considered-in-arm_neon/1477300
-# else
-#  include <arm_neon.h>
-# endif
-#else
-# define TC_JSON_SIMD 0
-#endif
+#include <bit>
 
 namespace tc::json {
 	namespace no_adl {
@@ -227,7 +216,11 @@ namespace tc::json {
 						/*sinkch*/tc::identity(),
 						/*sinkcp*/[&](auto const ch32) noexcept {
 							STATICASSERTSAME(decltype(ch32), char32_t const);
-							return tc::codepoint_codeunit_at<Char>(static_cast<unsigned int>(ch32), idx.m_nCodeUnitIndex);
+							if constexpr(std::same_as<Char, char>) { // only UTF-8 needs several code units per escaped code point
+								return tc::codepoint_codeunit_at<Char>(static_cast<unsigned int>(ch32), idx.m_nCodeUnitIndex);
+							} else {
+								return tc::explicit_cast<Char>(ch32);
+							}
 						}
 					);
 				} else {
@@ -254,7 +247,9 @@ namespace tc::json {
 					);
 				} else {
 					tc::increment_index(base, idx.m_baseidx);
-					_ASSERTDEBUGEQUAL(idx.m_nCodeUnitIndex, 0);
+					if constexpr(std::same_as<Char, char>) {
+						_ASSERTDEBUGEQUAL(idx.m_nCodeUnitIndex, 0);
+					}
 				}
 			}
 
@@ -376,6 +371,60 @@ namespace tc::json {
 		return no_adl::group<false,Keys...>(tc_move(keys)...);
 	}
 
+	namespace no_adl {
+		// Finds the characters inside strings in consecutive 64 byte blocks, given the masks of quotes and backslashes of each block.
+		struct string_block_scanner final {
+			struct masks final {
+				std::uint64_t m_nQuote; // unescaped quotes
+				std::uint64_t m_nInString; // from an opening quote up to, but excluding, the closing quote
+			};
+
+			masks operator()(std::uint64_t const nQuote, std::uint64_t const nBackslash) & noexcept {
+				// Characters following an odd number of backslashes are escaped (https://github.com/simdjson/simdjson/blob/master/include/simdjson/generic/ondemand/json_iterator.h).
+				static auto constexpr c_nOddBits = 0xAAAAAAAAAAAAAAAAull;
+				auto const nPotentialEscape = nBackslash & ~m_nEscapedCarry;
+				auto const nEscapeAndTerminalCode = (((nPotentialEscape << 1) | c_nOddBits) - nPotentialEscape) ^ c_nOddBits;
+				auto const nEscaped = nEscapeAndTerminalCode ^ (nBackslash | m_nEscapedCarry);
+				m_nEscapedCarry = (nEscapeAndTerminalCode & nBackslash) >> 63;
+
+				// Prefix XOR over the unescaped quotes.
+				auto const nQuoteUnescaped = nQuote & ~nEscaped;
+				auto nInString = nQuoteUnescaped;
+				for (int nShift = 1; nShift < 64; nShift *= 2) {
+					nInString ^= nInString << nShift;
+				}
+				nInString ^= m_nInStringCarry;
+				m_nInStringCarry = 0 - (nInString >> 63);
+				return {nQuoteUnescaped, nInString};
+			}
+
+		private:
+			std::uint64_t m_nEscapedCarry = 0; // 1 if the first character of the next block is escaped
+			std::uint64_t m_nInStringCarry = 0; // all bits set if the next block starts inside a string
+		};
+
+		// Calls func(pch, nOffset) for each 64 byte block of [pchBegin, pchEnd). The last block is padded with spaces, which is neutral outside of strings.
+		template<typename Char, typename Func>
+		auto for_each_block(Char const* const pchBegin, Char const* const pchEnd, Func func) MAYTHROW
+			-> tc::common_type_t<decltype(tc::continue_if_not_break(func, pchBegin, std::size_t())), tc::constant<tc::continue_>>
+		{
+			auto const nSize = tc::explicit_cast<std::size_t>(pchEnd - pchBegin);
+			std::size_t nOffset = 0;
+			for (; nOffset + 64 <= nSize; nOffset += 64) {
+				tc_return_if_break(tc::continue_if_not_break(func, pchBegin + nOffset, nOffset));
+			}
+			if (nOffset < nSize) {
+				std::array<Char, 64> achBlock;
+				tc::fill(achBlock, tc::explicit_cast<Char>(' '));
+				std::copy(pchBegin + nOffset, pchEnd, tc::begin(achBlock));
+				tc_return_if_break(tc::continue_if_not_break(func, tc::as_const(achBlock).data(), nOffset));
+			}
+			return tc::constant<tc::continue_>();
+		}
+	}
+
+	DEFINE_TAG_TYPE(trusted_input_tag)
+
 	namespace no_adl {
 
 		struct skip_exception {};
@@ -438,30 +487,14 @@ namespace tc::json {
 
 			template<typename T>
 			std::optional<T> number() & MAYTHROW {
-				static_assert(tc::common_range<String>, "Spirit requires common ranges"); // TODO?
-				if ( auto const ch = this->unchecked_peek(); '-'_tc != ch && !tc::make_interval('0'_tc, '9'_tc).contains_inclusive(ch) ) {
-					return std::nullopt;
-				}
-
-				// TODO: the x3 parsers don't follow the exact same grammar as JSON numbers
-				std::optional<T> ot(std::in_place);
-				if constexpr( std::floating_point<T> ) {
-					auto it = this->position();
-					if (!tc::parse_iterator(it, this->end_position(), x3::real_parser<T>(), *ot)) {
-						ot=std::nullopt;
-					}
-					this->set_position(it);
-					this->skip_whitespace_maybe_end();
-				} else {
-					static_assert( tc::actual_integer<T> );
-					auto it = this->position();
-					if (!tc::parse_iterator(it, this->end_position(), x3::int_parser<T>(), *ot)) {
-						ot=std::nullopt;
+				auto const itchBegin = this->position();
+				if (auto const ostr = number()) { // MAYTHROW
+					if (auto ot = tc::number_from_json_string<T>(*ostr)) {
+						return ot;
 					}
-					this->set_position(it);
-					this->skip_whitespace_maybe_end();
+					this->set_position(itchBegin); // not representable as T
 				}
-				return ot;
+				return std::nullopt;
 			}
 			template<typename T>
 			T expect_number() & MAYTHROW {
@@ -909,63 +942,113 @@ namespace tc::json {
 				}
 			}
 
-			using parser_base<String, ErrorHandler>::expect_end;
-
-		private:
-			// Precondition: We have just consumed the opening '"'.
-			auto read_string() & MAYTHROW {
-				auto itchBegin = this->position();
+			// Skips arrays and objects by counting brackets outside of strings, without validating the skipped tokens.
+			// Only for trusted input: errors inside the skipped value are not reported.
+			void skip_value(tc::json::trusted_input_tag_t) & MAYTHROW {
+				switch (this->unchecked_peek()) {
+				case '[':
+				case '{':
+					break;
+				default:
+					skip_value(); // MAYTHROW, scalars are cheap to validate
+					return;
+				}
 
-				#if TC_JSON_SIMD
-				if constexpr (sizeof(char_type) == 1 && tc::contiguous_range<String> && tc::common_range<String>) {
-					// Quickly fast forward to first occurrence of byte values 0-0x1F (control characters), 0x22 ("), 0x5C (\) or 0x80-0xFF (non-ascii).
+				std::size_t nDepth = 0;
+				if constexpr (parser_base<String, ErrorHandler>::c_bVectorizable) {
+					auto const pchBegin = std::to_address(this->position());
+					no_adl::string_block_scanner scanner;
+					if (tc::break_ == no_adl::for_each_block(pchBegin, std::to_address(this->end_position()), [&](char_type const* const pch, std::size_t const nOffset) noexcept {
+						auto const [nQuote, nBackslash, nOpen, nClose] = tc::simd::block_masks<
+							tc::simd::any_of<'"'>,
+							tc::simd::any_of<'\\'>,
+							tc::simd::any_of<'[', '{'>,
+							tc::simd::any_of<']', '}'>
+						>(pch);
+						auto const masks = scanner(nQuote, nBackslash);
+						auto const nOpenStructural = nOpen & ~masks.m_nInString;
+						auto const nCloseStructural = nClose & ~masks.m_nInString;
+						auto const nCountClose = tc::explicit_cast<std::size_t>(std::popcount(nCloseStructural));
+						if (nCountClose < nDepth) {
+							// The value cannot end in this block.
+							nDepth = nDepth + std::popcount(nOpenStructural) - nCountClose;
+							return tc::continue_;
+						}
+						for (auto nBracket = nOpenStructural | nCloseStructural; 0 != nBracket; nBracket &= nBracket - 1) {
+							auto const nBit = tc::index_of_least_significant_bit(nBracket);
+							if (0 != (nOpenStructural & (std::uint64_t(1) << nBit))) {
+								++nDepth;
+							} else if (0 == --nDepth) {
+								this->set_position(this->position() + (nOffset + nBit + 1));
+								return tc::break_;
+							}
+						}
+						return tc::continue_;
+					})) {
+						this->skip_whitespace_maybe_end();
+						return;
+					}
+					this->set_position(this->end_position());
+				} else {
+					bool bInString = false;
+					bool bEscaped = false;
 					auto it = this->position();
-					auto const end = this->end_position();
-					for(;;) {
-						if (16 <= end - it) {
-						#if BOOST_ARCH_X86
-							auto const m128Chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(std::to_address(it)));
-							auto const nSpecialCaseMask = static_cast<std::uint16_t>(_mm_movemask_epi8( // get 16 most significant bits as bitmask
-								_mm_or_si128(
-									_mm_or_si128(
-										_mm_cmpeq_epi8(m128Chunk, _mm_set1_epi8('"')), // sets lane to 0xFF, if quote
-										_mm_cmpeq_epi8(m128Chunk, _mm_set1_epi8('\\')) // sets lane to 0xFF, if backslash
-									),
-									_mm_cmplt_epi8(m128Chunk, _mm_set1_epi8(0x20)) // sets lane to 0xFF, if control character or non-ascii
-								)
-							));
-						#else
-							auto const s8x16Chunk = vld1q_s8(reinterpret_cast<std::int8_t const*>(std::to_address(it)));
-							// https://community.arm.com/arm-community-blogs/b/infrastructure-solutions-blog/posts/porting-x86-vector-bitmask-optimizations-to-arm-neon
-							auto const nSpecialCaseMask = vget_lane_u64(
-								vreinterpret_u64_u8( // treat 8 bytes as 64 bit word
-									vshrn_n_u16( // shift 16bit word right by 4, s.t., the low byte in each word contain a nibble of the original low byte and the original high byte, and return the 8 resulting low bytes
-										vreinterpretq_u16_u8(vorrq_u8(
-											vorrq_u8(
-												vceqq_s8(s8x16Chunk, vdupq_n_s8('"')), // sets lane to 0xFF, if quote
-												vceqq_s8(s8x16Chunk, vdupq_n_s8('\\')) // sets lane to 0xFF, if backslash
-											),
-											vcltq_s8(s8x16Chunk, vdupq_n_s8(0x20)) // sets lane to 0xFF, if control character or non-ascii
-										)),
-										4
-									)
-								),
-								0
-							);
-						#endif
-							if(0 != nSpecialCaseMask) {
-								it += tc::index_of_least_significant_bit(nSpecialCaseMask) / (BOOST_ARCH_ARM ? 4 : 1);
+					for (; it != this->end_position(); ++it) {
+						auto const ch = *it;
+						if (bInString) {
+							if (bEscaped) {
+								bEscaped = false;
+							} else if ('\\' == ch) {
+								bEscaped = true;
+							} else if ('"' == ch) {
+								bInString = false;
+							}
+						} else {
+							switch (ch) {
+							case '"':
+								bInString = true;
+								break;
+							case '[':
+							case '{':
+								++nDepth;
+								break;
+							case ']':
+							case '}':
+								if (0 == --nDepth) {
+									this->set_position(++it);
+									this->skip_whitespace_maybe_end();
+									return;
+								}
 								break;
-							} else {
-								it += 16;
 							}
-						} else /*not near EOI most of the time*/[[unlikely]] {
-							break;
 						}
 					}
 					this->set_position(it);
 				}
-				#endif
+				this->expect_not_end(); // MAYTHROW
+			}
+
+			using parser_base<String, ErrorHandler>::expect_end;
+
+		private:
+			// Precondition: We have just consumed the opening '"'.
+			auto read_string() & MAYTHROW {
+				auto itchBegin = this->position();
+
+				auto const fast_forward = [&]() noexcept {
+					if constexpr (parser_base<String, ErrorHandler>::c_bVectorizableFind) {
+						// Quickly fast forward to first occurrence of code units 0-0x1F (control characters), 0x22 ("), 0x5C (\) or, in UTF-8, 0x80-0xFF (non-ascii).
+						// As in the loop below, UTF-16 code units are not validated.
+						auto const it = this->position();
+						auto const pch = std::to_address(it);
+						this->set_position(it + (tc::simd::find_first_of<tc::simd::code_unit_set<
+							0x20,
+							sizeof(char_type) == 1 ? 0x7F : std::numeric_limits<unsigned int>::max(),
+							'"', '\\'
+						>>(pch, std::to_address(this->end_position())) - pch));
+					}
+				};
+				fast_forward();
 
 				for (;;) {
 					this->expect_not_end();
@@ -1004,12 +1087,16 @@ namespace tc::json {
 						default:
 							this->template error<tc_mem_fn(.invalid_escape)>(); // MAYTHROW
 						}
+						fast_forward();
 						break;
 
 					default:
 						if (tc::make_interval(0x00, 0x1F).contains_inclusive(ch)) {
 							// The control characters (U+0000 through U+001F) must be escaped (RFC 8259). U+007F is fine.
 							this->template error<tc_mem_fn(.unescaped_control_character)>(); // MAYTHROW
+						} else if constexpr (parser_base<String, ErrorHandler>::c_bVectorizable) {
+							// Validates the non-ASCII text up to the closing quote, the next escape or the next control character at once.
+							this->template skip_utf8_until<tc::simd::code_unit_set<0x20, std::numeric_limits<unsigned int>::max(), '"', '\\'>>(); // MAYTHROW
 						} else {
 							this->unchecked_increment();
 							if constexpr (sizeof(char_type) == 1) {
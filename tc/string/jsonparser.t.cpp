@@ -418,6 +418,152 @@ UNITTESTDEF(JSONDecode) {
 	Test(R"(\uD800\uD834\uDD1E\uD800\u20AC)", "\uFFFD\U0001D11E\uFFFD\u20AC");
 }
 
+UNITTESTDEF(JSONLongString) {
+	// Long runs of plain characters are skipped a whole vector at a time, special characters must still be found at every offset.
+	auto const strRunMax = tc::make_str(tc::repeat_n(100, 'a'));
+	for (int n = 0; n < 100; ++n) {
+		auto const strRun = tc::begin_next<tc::return_take>(strRunMax, n);
+		_ASSERT(Accepts(tc::make_str(tc::concat("[\"", strRun, "\\n", strRun, "\u20AC", strRun, "\"]"))));
+		_ASSERT(Accepts(tc::make_str(tc::concat("\"", strRun, "\\u0041", strRun, "\""))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, "\t", strRun, "\""))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, "\\x", strRun, "\""))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, strRun))));
+
+		auto const strJson = tc::make_str(tc::concat("\"", strRun, "\\\"", strRun, "\""));
+		auto parser = tc::json::parser(strJson, tc::json::simple_error_handler(tc::never_called()));
+		_ASSERT(tc::equal(parser.expect_string(), tc::concat(strRun, "\"", strRun)));
+		parser.expect_end();
+	}
+}
+
+UNITTESTDEF(JSONUtf8) {
+	// Non-ASCII text is validated a whole vector at a time, invalid sequences must still be found at every offset.
+	tc::string<char> strRun;
+	for (int n = 0; n < 50; ++n) {
+		_ASSERT(Accepts(tc::make_str(tc::concat("[\"", strRun, "\\n", strRun, "\U0001D11E\"]"))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, "\xFF", strRun, "\""))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, "\xED\xA0\x80", strRun, "\""))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, "\xE2\x82\""))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, "\xE2\x82"))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("\"", strRun, "\n", strRun, "\""))));
+
+		auto const strJson = tc::make_str(tc::concat("\"", strRun, "\\\"", strRun, "\""));
+		auto parser = tc::json::parser(strJson, tc::json::simple_error_handler(tc::never_called()));
+		_ASSERT(tc::equal(parser.expect_string(), tc::concat(strRun, "\"", strRun)));
+		parser.expect_end();
+
+		tc::append(strRun, 0 == n % 3 ? "\u0436" : "\u20AC");
+	}
+}
+
+UNITTESTDEF(JSONUtf16) {
+	// UTF-16 input is searched a whole vector at a time as well, special characters must still be found at every offset.
+	auto const strRunMax = tc::make_str<tc::char16>(tc::repeat_n(100, tc::char16{0x20AC}));
+	for (int n = 0; n < 100; ++n) {
+		auto const strRun = tc::begin_next<tc::return_take>(strRunMax, n);
+		auto const strIndent = tc::make_str<tc::char16>(tc::concat(u"\r\n", tc::repeat_n(n, tc::char16{' '})));
+		_ASSERT(Accepts(tc::make_str<tc::char16>(tc::concat(u"[", strIndent, u"\"", strRun, u"\\n", strRun, u"\"", strIndent, u",", strIndent, u"1", strIndent, u"]", strIndent))));
+		_ASSERT(!Accepts(tc::make_str<tc::char16>(tc::concat(u"\"", strRun, u"\t", strRun, u"\""))));
+		_ASSERT(!Accepts(tc::make_str<tc::char16>(tc::concat(u"\"", strRun, strRun))));
+		_ASSERT(!Accepts(tc::make_str<tc::char16>(tc::concat(u"[", strIndent, u"\v]"))));
+
+		auto const strJson = tc::make_str<tc::char16>(tc::concat(u"\"", strRun, u"\\\"", strRun, u"\""));
+		auto parser = tc::json::parser(strJson, tc::json::simple_error_handler(tc::never_called()));
+		_ASSERT(tc::equal(parser.expect_string(), tc::concat(strRun, u"\"", strRun)));
+		parser.expect_end();
+	}
+}
+
+UNITTESTDEF(JSONWhitespace) {
+	for (int n = 0; n < 100; ++n) {
+		auto const strIndent = tc::make_str(tc::concat("\r\n", tc::repeat_n(n, tc::explicit_cast<char>(0 == n % 3 ? '\t' : ' '))));
+		auto const strJson = tc::make_str(tc::concat("{", strIndent, "\"a\"", strIndent, ":", strIndent, "[", strIndent, "1", strIndent, ",", strIndent, "2", strIndent, "]", strIndent, "}", strIndent));
+		_ASSERT(Accepts(strJson));
+		_ASSERT(!Accepts(tc::make_str(tc::concat(strJson, "\v"))));
+		_ASSERT(!Accepts(tc::make_str(tc::concat("[", strIndent))));
+	}
+}
+
+UNITTESTDEF(JSONSkipTrusted) {
+	auto const CheckSkip = [](auto const& str) noexcept {
+		auto parser = tc::json::parser(str, tc::json::simple_error_handler(tc::never_called()));
+		parser.expect_object();
+		auto const strKeySkip = parser.key();
+		_ASSERT(strKeySkip && tc::equal(*strKeySkip, "skip"));
+		parser.skip_value(tc::json::trusted_input_tag);
+		auto const strKeyB = parser.key();
+		_ASSERT(strKeyB && tc::equal(*strKeyB, "b"));
+		_ASSERTEQUAL(parser.template expect_number<int>(), 2);
+		_ASSERT(!parser.key());
+		parser.expect_end();
+	};
+
+	tc::string<char> strValue = "{}";
+	for (int i = 0; i < 100; ++i) {
+		// Brackets and escaped quotes inside strings, nesting deeper than a block holds closing brackets.
+		strValue = tc::make_str(tc::concat(
+			"[", tc::repeat_n(i % 5, ' '), "{\"k\\\\\": \"]}\\\"[\", \"v\":", strValue, ", \"w\": [1, true, null, \"\"]}", tc::repeat_n(i % 3, '\n'), "]"
+		));
+		auto const strJson = tc::make_str(tc::concat("{\"skip\": ", strValue, " , \"b\": 2}"));
+		_ASSERT(Accepts(strJson));
+		CheckSkip(strJson);
+		CheckSkip(tc::transform(strJson, tc::identity())); // not contiguous
+	}
+	CheckSkip(tc::make_str("{\"skip\":\"a\",\"b\":2}"));
+
+	// Backslash runs of all lengths, placed across the 64 byte block boundary. After odd runs, the quote and bracket are escaped and part of the string.
+	for (int nBackslash = 0; nBackslash < 8; ++nBackslash) {
+		for (int nPadding = 50; nPadding < 70; ++nPadding) {
+			auto const strJson = tc::make_str(tc::concat(
+				"{\"skip\": [\"", tc::repeat_n(nPadding, 'a'), tc::repeat_n(nBackslash, '\\'), 1 == nBackslash % 2 ? "\"]" : "", "\"], \"b\": 2}"
+			));
+			_ASSERT(Accepts(strJson));
+			CheckSkip(strJson);
+		}
+	}
+
+	auto const Skips = [](auto const& str) noexcept {
+		struct ExFailure final {};
+		try {
+			auto parser = tc::json::parser(
+				str,
+				tc::json::simple_error_handler([](tc::unused) THROW(ExFailure) {
+					throw ExFailure();
+				})
+			);
+			parser.skip_value(tc::json::trusted_input_tag); // THROW(ExFailure)
+			return true;
+		} catch (ExFailure const&) {
+			return false;
+		}
+	};
+	for (auto const str : {"[[]", "{\"]\"", "[\"\\\"]\"", "{\"a\": [\"]\"}"}) {
+		_ASSERT(!Skips(tc::make_str(str)));
+		_ASSERT(!Skips(tc::transform(tc::make_str(str), tc::identity())));
+	}
+	// Trusted skipping does not validate.
+	_ASSERT(Skips(tc::make_str("[1 2 {]]]")));
+}
+
+UNITTESTDEF(JSONNumber) {
+	auto parser = tc::json::parser(tc::make_str("[0.1, -25, 1e400 ,12345678901234567890, 1.5e-3]"), tc::json::simple_error_handler(tc::never_called()));
+	parser.expect_array();
+	parser.expect_element();
+	_ASSERTEQUAL(parser.expect_number<double>(), 0.1);
+	parser.expect_element();
+	_ASSERTEQUAL(parser.expect_number<int>(), -25);
+	parser.expect_element();
+	_ASSERTEQUAL(parser.expect_number<double>(), std::numeric_limits<double>::infinity());
+	parser.expect_element();
+	_ASSERT(!parser.number<std::int64_t>()); // too large, position is unchanged
+	_ASSERTEQUAL(parser.expect_number<std::uint64_t>(), 12345678901234567890u);
+	parser.expect_element();
+	_ASSERT(!parser.number<int>()); // not an integer
+	_ASSERTEQUAL(parser.expect_number<float>(), 1.5e-3f);
+	_ASSERT(!parser.element());
+	parser.expect_end();
+}
+
 #pragma pop_macro("AS_ARRAY")
 
 UNITTESTDEF(JSONArray_Manual) {
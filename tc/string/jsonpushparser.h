@@ -0,0 +1,292 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "jsonparser.h"
+#include "../container/insert.h"
+#include "../algorithm/append.h"
+#include "../base/modified.h"
+
+namespace tc::json {
+	namespace push_parser_detail {
+		TC_DEFINE_ENUM(EExpected, eexpected, (VALUE)(FIRSTELEMENT)(FIRSTKEY)(KEY)(COLON)(COMMA)(END))
+		TC_DEFINE_ENUM(EToken, etoken, (NONE)(STRING)(NUMBER)(LITERAL))
+	}
+
+	namespace no_adl {
+		// Parses JSON that arrives in chunks, e.g., from a socket, without concatenating the chunks first.
+		// Calls the member functions null(), boolean(b), number(str), string(str), key(str), begin_array(), end_array(), begin_object() and end_object() of Handler,
+		// like a SAX parser. Strings are passed decoded and lazily, as tc::json::decode of the raw token, and only live until the member function returns.
+		// Memory is bounded by the nesting depth and the longest string or number that is split between two chunks, which is the only part of the input that is copied.
+		// Errors inside strings and numbers are reported relative to the token, all other errors relative to the current chunk.
+		template<typename Char, typename Handler, typename ErrorHandler>
+		struct [[nodiscard]] push_parser final : tc::noncopyable {
+			explicit push_parser(Handler handler, ErrorHandler errorhandler) noexcept
+				: m_handler(tc_move(handler))
+				, m_errorhandler(tc_move(errorhandler))
+			{}
+
+			explicit operator bool() const& noexcept {
+				return !m_bError;
+			}
+
+			Handler& handler() & noexcept {
+				return m_handler;
+			}
+			Handler const& handler() const& noexcept {
+				return m_handler;
+			}
+
+			// The chunk may be destroyed after push returns.
+			template<typename Chunk>
+			void push(Chunk const& chunk) & MAYTHROW {
+				static_assert(std::is_same<tc::range_value_t<Chunk const&>, Char>::value);
+				_ASSERT(*this);
+				auto itch = tc::begin(chunk);
+				auto const itchEnd = tc::end(chunk);
+
+				if (push_parser_detail::etokenNONE != m_etoken) {
+					// Continue the token that was split at the end of the previous chunk.
+					auto const oitchTokenEnd = find_token_end(itch, itchEnd);
+					tc::append(m_strToken, tc::make_iterator_range(itch, oitchTokenEnd ? *oitchTokenEnd : itchEnd));
+					if (!oitchTokenEnd) return;
+					itch = *oitchTokenEnd;
+					complete_token(m_strToken); // MAYTHROW
+					m_strToken.clear();
+				}
+
+				for (;;) {
+					itch = skip_whitespace(itch, itchEnd);
+					if (itch == itchEnd) return;
+					switch (auto const ch = *itch) {
+					case '[':
+					case '{':
+						expect_value(chunk, itch); // MAYTHROW
+						tc::cont_emplace_back(m_vecbArray, '[' == ch);
+						if ('[' == ch) {
+							m_eexpected = push_parser_detail::eexpectedFIRSTELEMENT;
+							m_handler.begin_array(); // MAYTHROW
+						} else {
+							m_eexpected = push_parser_detail::eexpectedFIRSTKEY;
+							m_handler.begin_object(); // MAYTHROW
+						}
+						++itch;
+						break;
+
+					case ']':
+					case '}':
+						if (push_parser_detail::eexpectedFIRSTELEMENT == m_eexpected ? ']' != ch
+							: push_parser_detail::eexpectedFIRSTKEY == m_eexpected ? '}' != ch
+							: push_parser_detail::eexpectedCOMMA != m_eexpected || tc::back(m_vecbArray) != (']' == ch)
+						) {
+							unexpected(chunk, itch); // MAYTHROW
+						}
+						tc::drop_last_inplace(m_vecbArray);
+						if (']' == ch) {
+							m_handler.end_array(); // MAYTHROW
+						} else {
+							m_handler.end_object(); // MAYTHROW
+						}
+						after_value();
+						++itch;
+						break;
+
+					case ',':
+						if (push_parser_detail::eexpectedCOMMA != m_eexpected) unexpected(chunk, itch); // MAYTHROW
+						m_eexpected = tc::back(m_vecbArray) ? push_parser_detail::eexpectedVALUE : push_parser_detail::eexpectedKEY;
+						++itch;
+						break;
+
+					case ':':
+						if (push_parser_detail::eexpectedCOLON != m_eexpected) unexpected(chunk, itch); // MAYTHROW
+						m_eexpected = push_parser_detail::eexpectedVALUE;
+						++itch;
+						break;
+
+					default: {
+						if ('"' == ch) {
+							if (push_parser_detail::eexpectedFIRSTKEY != m_eexpected && push_parser_detail::eexpectedKEY != m_eexpected) {
+								expect_value(chunk, itch); // MAYTHROW
+							}
+							m_etoken = push_parser_detail::etokenSTRING;
+						} else if ('-' == ch || tc::isasciidigit(ch)) {
+							expect_value(chunk, itch); // MAYTHROW
+							m_etoken = push_parser_detail::etokenNUMBER;
+						} else if ('n' == ch || 't' == ch || 'f' == ch) {
+							expect_value(chunk, itch); // MAYTHROW
+							m_etoken = push_parser_detail::etokenLITERAL;
+						} else {
+							unexpected(chunk, itch); // MAYTHROW
+						}
+
+						auto const itchTokenBegin = itch;
+						auto const oitchTokenEnd = find_token_end(tc_modified(itch, ++_), itchEnd);
+						if (!oitchTokenEnd) {
+							// Only the incomplete token at the end of the chunk is copied.
+							tc::append(m_strToken, tc::make_iterator_range(itchTokenBegin, itchEnd));
+							return;
+						}
+						itch = *oitchTokenEnd;
+						complete_token(tc::make_iterator_range(itchTokenBegin, itch)); // MAYTHROW
+						break;
+					}
+					}
+				}
+			}
+
+			// Signals the end of the input: numbers and literals at the end of the last chunk are complete now.
+			void finish() & MAYTHROW {
+				_ASSERT(*this);
+				switch_no_default (m_etoken) {
+				case push_parser_detail::etokenNONE:
+					break;
+				case push_parser_detail::etokenSTRING:
+					error_at<tc_mem_fn(.end_unexpected)>(m_strToken, tc::end(m_strToken)); // MAYTHROW
+				case push_parser_detail::etokenNUMBER:
+				case push_parser_detail::etokenLITERAL:
+					complete_token(m_strToken); // MAYTHROW
+					m_strToken.clear();
+					break;
+				}
+				if (push_parser_detail::eexpectedEND != m_eexpected) {
+					error_at<tc_mem_fn(.end_unexpected)>(m_strToken, tc::end(m_strToken)); // MAYTHROW
+				}
+			}
+
+		private:
+			template<typename Iterator, typename Sentinel>
+			static Iterator skip_whitespace(Iterator itch, Sentinel const itchEnd) noexcept {
+				if constexpr (1 == sizeof(Char) && std::contiguous_iterator<Iterator> && std::same_as<Iterator, Sentinel>) {
+					auto const pch = std::to_address(itch);
+					return itch + (tc::simd::find_first_not_of<tc::simd::any_of<'\t', '\n', '\r', ' '>>(pch, std::to_address(itchEnd)) - pch);
+				} else {
+					while (itch != itchEnd && ('\t' == *itch || '\n' == *itch || '\r' == *itch || ' ' == *itch)) ++itch;
+					return itch;
+				}
+			}
+
+			// Returns the end of the current token, or std::nullopt if the token continues in the next chunk.
+			template<typename Iterator, typename Sentinel>
+			std::optional<Iterator> find_token_end(Iterator itch, Sentinel const itchEnd) & noexcept {
+				if (push_parser_detail::etokenSTRING == m_etoken) {
+					for (;;) {
+						if constexpr (1 == sizeof(Char) && std::contiguous_iterator<Iterator> && std::same_as<Iterator, Sentinel>) {
+							if (!m_bEscaped) {
+								auto const pch = std::to_address(itch);
+								itch += tc::simd::find_first_of<tc::simd::any_of<'"', '\\'>>(pch, std::to_address(itchEnd)) - pch;
+							}
+						}
+						if (itch == itchEnd) return std::nullopt;
+						if (tc::change(m_bEscaped, false)) {
+							// The escaped character cannot end the string, read_string validates the escape sequence.
+						} else if ('\\' == *itch) {
+							m_bEscaped = true;
+						} else if ('"' == *itch) {
+							return ++itch;
+						}
+						++itch;
+					}
+				} else {
+					// Numbers and literals end at the first character that cannot be part of them, read_number validates the token.
+					for (; itch != itchEnd; ++itch) {
+						auto const ch = *itch;
+						if (!tc::isasciidigit(ch) && !tc::isasciilower(ch) && 'E' != ch && '+' != ch && '-' != ch && '.' != ch) return itch;
+					}
+					return std::nullopt;
+				}
+			}
+
+			template<typename Token>
+			void complete_token(Token const& token) & MAYTHROW {
+				switch_no_default (std::exchange(m_etoken, push_parser_detail::etokenNONE)) {
+				case push_parser_detail::etokenSTRING: {
+					tc::json::parser parser(token, m_errorhandler); // MAYTHROW
+					auto const str = parser.expect_string(); // MAYTHROW
+					parser.expect_end(); // MAYTHROW
+					if (push_parser_detail::eexpectedFIRSTKEY == m_eexpected || push_parser_detail::eexpectedKEY == m_eexpected) {
+						m_eexpected = push_parser_detail::eexpectedCOLON;
+						m_handler.key(str); // MAYTHROW
+					} else {
+						m_handler.string(str); // MAYTHROW
+						after_value();
+					}
+					break;
+				}
+				case push_parser_detail::etokenNUMBER: {
+					tc::json::parser parser(token, m_errorhandler); // MAYTHROW
+					auto const ostr = parser.number(); // MAYTHROW
+					_ASSERT(ostr); // the token starts with '-' or a digit
+					parser.expect_end(); // MAYTHROW
+					m_handler.number(*ostr); // MAYTHROW
+					after_value();
+					break;
+				}
+				case push_parser_detail::etokenLITERAL:
+					if (tc::equal(token, "null")) {
+						m_handler.null(); // MAYTHROW
+					} else if (tc::equal(token, "true")) {
+						m_handler.boolean(true); // MAYTHROW
+					} else if (tc::equal(token, "false")) {
+						m_handler.boolean(false); // MAYTHROW
+					} else {
+						error_at<tc_mem_fn(.value_expected)>(token, tc::begin(token)); // MAYTHROW
+					}
+					after_value();
+					break;
+				}
+			}
+
+			void after_value() & noexcept {
+				m_eexpected = tc::empty(m_vecbArray) ? push_parser_detail::eexpectedEND : push_parser_detail::eexpectedCOMMA;
+			}
+
+			template<typename Chunk, typename Iterator>
+			void expect_value(Chunk const& chunk, Iterator const itch) & MAYTHROW {
+				if (push_parser_detail::eexpectedVALUE != m_eexpected && push_parser_detail::eexpectedFIRSTELEMENT != m_eexpected) {
+					unexpected(chunk, itch); // MAYTHROW
+				}
+			}
+
+			template<typename Chunk, typename Iterator>
+			[[noreturn]] void unexpected(Chunk const& chunk, Iterator const itch) & MAYTHROW {
+				switch_no_default (m_eexpected) {
+				case push_parser_detail::eexpectedVALUE:
+				case push_parser_detail::eexpectedFIRSTELEMENT:
+					error_at<tc_mem_fn(.value_expected)>(chunk, itch); // MAYTHROW
+				case push_parser_detail::eexpectedFIRSTKEY:
+				case push_parser_detail::eexpectedKEY:
+					error_at<tc_mem_fn(.key_expected)>(chunk, itch); // MAYTHROW
+				case push_parser_detail::eexpectedCOLON:
+					error_at<tc_mem_fn(.char_expected)>(chunk, itch, tc::char_ascii(':')); // MAYTHROW
+				case push_parser_detail::eexpectedCOMMA:
+					error_at<tc_mem_fn(.char_expected)>(chunk, itch, tc::char_ascii(',')); // MAYTHROW
+				case push_parser_detail::eexpectedEND:
+					error_at<tc_mem_fn(.end_expected)>(chunk, itch); // MAYTHROW
+				}
+			}
+
+			template<auto memfn, typename Rng, typename Iterator, typename... Args>
+			[[noreturn]] void error_at(Rng const& rng, Iterator const itch, Args&&... args) & MAYTHROW {
+				m_bError = true;
+				memfn(m_errorhandler, rng, itch, tc_move_if_owned(args)...); // MAYTHROW
+				_ASSERTNORETURNFALSE;
+			}
+
+			Handler m_handler;
+			ErrorHandler m_errorhandler;
+			tc::vector<bool> m_vecbArray; // for each open array or object, whether it is an array
+			tc::string<Char> m_strToken; // the beginning of a token that was split between chunks
+			push_parser_detail::EExpected m_eexpected = push_parser_detail::eexpectedVALUE;
+			push_parser_detail::EToken m_etoken = push_parser_detail::etokenNONE;
+			bool m_bEscaped = false; // the last character of the previous chunk is an unescaped backslash in a string
+			bool m_bError = false;
+		};
+	}
+	using no_adl::push_parser;
+}
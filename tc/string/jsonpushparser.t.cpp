@@ -0,0 +1,74 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "jsonpushparser.h"
+
+namespace {
+	// Records the events as a string.
+	struct SRecordingHandler final {
+		void null() & noexcept { tc::append(m_str, "n "); }
+		void boolean(bool const b) & noexcept { tc::append(m_str, b ? "t " : "f "); }
+		void number(auto const& str) & noexcept { tc::append(m_str, "#", str, " "); }
+		void string(auto const& str) & noexcept { tc::append(m_str, "s:", str, " "); }
+		void key(auto const& str) & noexcept { tc::append(m_str, "k:", str, " "); }
+		void begin_array() & noexcept { tc::append(m_str, "[ "); }
+		void end_array() & noexcept { tc::append(m_str, "] "); }
+		void begin_object() & noexcept { tc::append(m_str, "{ "); }
+		void end_object() & noexcept { tc::append(m_str, "} "); }
+
+		tc::string<char> m_str;
+	};
+
+	struct ExFailure final {};
+
+	// Pushes str in chunks of nChunk characters.
+	std::optional<tc::string<char>> PushParse(tc::string<char> const& str, std::size_t const nChunk) noexcept {
+		auto errorhandler = tc::json::simple_error_handler([](tc::unused) THROW(ExFailure) {
+			throw ExFailure();
+		});
+		tc::json::push_parser<char, SRecordingHandler, decltype(errorhandler)> parser(SRecordingHandler(), errorhandler);
+		try {
+			for (std::size_t i = 0; i < tc::size(str); i += nChunk) {
+				// Copy the chunk, the parser must not keep references to it.
+				tc::string<char> const strChunk(tc::begin(str) + i, tc::begin(str) + tc::min(i + nChunk, tc::size(str)));
+				parser.push(strChunk); // THROW(ExFailure)
+			}
+			parser.finish(); // THROW(ExFailure)
+		} catch (ExFailure const&) {
+			return std::nullopt;
+		}
+		return tc_move_always(parser.handler().m_str);
+	}
+
+	void CheckPushParse(char const* const sz, std::optional<char const*> const osExpected) noexcept {
+		auto const str = tc::make_str(sz);
+		for (std::size_t nChunk = 1; nChunk <= tc::size(str) + 1; ++nChunk) {
+			auto const ostr = PushParse(str, nChunk);
+			_ASSERTPRINT(ostr.has_value() == osExpected.has_value(), sz, " ", nChunk);
+			if (ostr) _ASSERTPRINT(tc::equal(*ostr, *osExpected), *ostr);
+		}
+	}
+}
+
+UNITTESTDEF(JSONPushParser) {
+	CheckPushParse("null", "n ");
+	CheckPushParse(" 123 ", "#123 ");
+	CheckPushParse("-0.5e+10", "#-0.5e+10 ");
+	CheckPushParse(R"("a\"b\\\\")", R"(s:a"b\\ )");
+	CheckPushParse(R"( [true, false, null, 1, "x\u20ACy", [], {}] )", "[ t f n #1 s:x\xE2\x82\xACy [ ] { } ] ");
+	CheckPushParse(R"({"a": {"b": [1, {"c": "d"}]}, "e\n": -1E2})", "{ k:a { k:b [ #1 { k:c s:d } ] } k:e\n #-1E2 } ");
+	CheckPushParse("\t[\r\n[[ ]]\n]\n", "[ [ [ ] ] ] ");
+
+	for (auto const sz : {
+		"", " ", "nul", "nulll", "True", "1.", "01", "-", "1x", "\"abc", "\"\\x\"", "\"\\u12\"", "\"\x01\"", "\"\xC0\xAF\"",
+		"[", "]", "[1,]", "[1 2]", "[,1]", "{\"a\"}", "{\"a\":}", "{\"a\" 1}", "{1:2}", "{\"a\":1,}", "[}", "{]", "[1]]", "1 2", "[] x"
+	}) {
+		CheckPushParse(sz, std::nullopt);
+	}
+}
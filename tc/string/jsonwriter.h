@@ -0,0 +1,180 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "jsonparser.h"
+#include "format.h"
+#include "../algorithm/append.h"
+
+#include <cmath>
+
+namespace tc::json {
+	namespace no_adl {
+		// The inverse of decode_adaptor: escapes '"', '\\' and the control characters U+0000 through U+001F, as required by RFC 8259.
+		// Runs of characters that need no escaping are passed to the sink as a whole, which an appender inserts at once.
+		template<typename Rng>
+		struct [[nodiscard]] encode_adaptor : tc::range_adaptor_base_range<Rng> {
+			using char_type = tc::range_value_t<Rng const&>;
+			friend auto range_output_t_impl(encode_adaptor const&) -> tc::type::list<char_type>; // declaration only
+
+			using tc::range_adaptor_base_range<Rng>::range_adaptor_base_range;
+
+			template<typename Sink>
+			auto operator()(Sink sink) const& MAYTHROW {
+				using return_t = tc::common_type_t<
+					decltype(tc::continue_if_not_break(sink, std::declval<char_type>())),
+					decltype(escape(std::declval<char_type>(), sink)),
+					tc::constant<tc::continue_>
+				>;
+				auto const& rng = this->base_range();
+				if constexpr (sizeof(char_type) <= 2 && tc::contiguous_range<Rng const&> && tc::common_range<Rng const&>) {
+					auto pch = tc::ptr_begin(rng);
+					auto const pchEnd = pch + tc::size(rng);
+					for (;;) {
+						auto const pchEscape = tc::simd::find_first_of<tc::simd::code_unit_set<0x20, std::numeric_limits<unsigned int>::max(), '"', '\\'>>(pch, pchEnd);
+						if (pch != pchEscape) tc_return_if_break(return_t(tc::for_each(tc::make_iterator_range(pch, pchEscape), sink))); // MAYTHROW
+						if (pchEnd == pchEscape) return return_t(tc::constant<tc::continue_>());
+						tc_return_if_break(return_t(escape(*pchEscape, sink))); // MAYTHROW
+						pch = pchEscape + 1;
+					}
+				} else {
+					return return_t(tc::for_each(rng, [&](char_type const ch) MAYTHROW -> return_t {
+						if (needs_escape(ch)) {
+							return escape(ch, sink); // MAYTHROW
+						} else {
+							return tc::continue_if_not_break(sink, ch); // MAYTHROW
+						}
+					}));
+				}
+			}
+
+		private:
+			static constexpr bool needs_escape(char_type const ch) noexcept {
+				return static_cast<std::make_unsigned_t<char_type>>(ch) < 0x20 || tc::explicit_cast<char_type>('"') == ch || tc::explicit_cast<char_type>('\\') == ch;
+			}
+
+			template<typename Sink>
+			static auto escape(char_type const ch, Sink& sink) MAYTHROW {
+				_ASSERTDEBUG(needs_escape(ch));
+				char_type ach[6] = {tc::explicit_cast<char_type>('\\')};
+				std::size_t n = 2;
+				switch (ch) {
+				case '"': ach[1] = tc::explicit_cast<char_type>('"'); break;
+				case '\\': ach[1] = tc::explicit_cast<char_type>('\\'); break;
+				case '\b': ach[1] = tc::explicit_cast<char_type>('b'); break;
+				case '\f': ach[1] = tc::explicit_cast<char_type>('f'); break;
+				case '\n': ach[1] = tc::explicit_cast<char_type>('n'); break;
+				case '\r': ach[1] = tc::explicit_cast<char_type>('r'); break;
+				case '\t': ach[1] = tc::explicit_cast<char_type>('t'); break;
+				default:
+					ach[1] = tc::explicit_cast<char_type>('u');
+					ach[2] = tc::explicit_cast<char_type>('0');
+					ach[3] = tc::explicit_cast<char_type>('0');
+					ach[4] = static_cast<char_type>('0' + (ch >> 4));
+					ach[5] = static_cast<char_type>("0123456789abcdef"[ch & 0xf]);
+					n = 6;
+					break;
+				}
+				char_type const* const pchBegin = ach;
+				return tc::for_each(tc::make_iterator_range(pchBegin, pchBegin + n), sink); // MAYTHROW
+			}
+		};
+	}
+
+	template<typename Rng>
+	constexpr auto encode(Rng&& rng)
+		return_ctor_noexcept( no_adl::encode_adaptor<Rng>, (aggregate_tag, tc_move_if_owned(rng)) )
+
+	namespace no_adl {
+		// Writes JSON into an appender, e.g., tc::json::writer writer(tc::appender(str)). Separators are inserted as needed, no whitespace is written.
+		// The member functions match the events of tc::json::push_parser, so a writer can be used as its Handler.
+		template<typename Appender>
+		struct [[nodiscard]] writer final {
+			explicit writer(Appender appender) noexcept
+				: m_appender(tc_move(appender))
+			{}
+
+			void null() & MAYTHROW {
+				write_value("null"); // MAYTHROW
+			}
+
+			void boolean(bool const b) & MAYTHROW {
+				if (b) {
+					write_value("true"); // MAYTHROW
+				} else {
+					write_value("false"); // MAYTHROW
+				}
+			}
+
+			template<tc::actual_integer T>
+			void number(T const n) & MAYTHROW {
+				write_value(tc::as_dec(n)); // MAYTHROW
+			}
+
+			// The shortest representation that is parsed as the same value. JSON has no infinity or NaN.
+			template<std::floating_point T>
+			void number(T const t) & MAYTHROW {
+				_ASSERT(std::isfinite(t));
+				write_value(tc::as_dec(t)); // MAYTHROW
+			}
+
+			// A number that is already formatted, e.g., as returned by tc::json::parser::number().
+			template<typename Rng> requires (!tc::actual_arithmetic<Rng>)
+			void number(Rng const& rng) & MAYTHROW {
+				write_value(rng); // MAYTHROW
+			}
+
+			template<typename Rng>
+			void string(Rng const& rng) & MAYTHROW {
+				write_value(tc::concat("\"", tc::json::encode(rng), "\"")); // MAYTHROW
+			}
+
+			template<typename Rng>
+			void key(Rng const& rng) & MAYTHROW {
+				write_value(tc::concat("\"", tc::json::encode(rng), "\":")); // MAYTHROW
+				m_bSeparator = false;
+			}
+
+			void begin_array() & MAYTHROW {
+				write_value("["); // MAYTHROW
+				m_bSeparator = false;
+			}
+			void end_array() & MAYTHROW {
+				write("]"); // MAYTHROW
+				m_bSeparator = true;
+			}
+
+			void begin_object() & MAYTHROW {
+				write_value("{"); // MAYTHROW
+				m_bSeparator = false;
+			}
+			void end_object() & MAYTHROW {
+				write("}"); // MAYTHROW
+				m_bSeparator = true;
+			}
+
+		private:
+			template<typename Rng>
+			void write(Rng const& rng) & MAYTHROW {
+				tc::for_each(rng, m_appender); // MAYTHROW
+			}
+
+			template<typename Rng>
+			void write_value(Rng const& rng) & MAYTHROW {
+				if (m_bSeparator) write(","); // MAYTHROW
+				write(rng); // MAYTHROW
+				m_bSeparator = true;
+			}
+
+			Appender m_appender;
+			bool m_bSeparator = false; // a ',' must precede the next value or key
+		};
+	}
+	using no_adl::writer;
+}
@@ -0,0 +1,88 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "jsonwriter.h"
+#include "jsonpushparser.h"
+#include "../range/transform_adaptor.h"
+
+#include <random>
+
+UNITTESTDEF(JSONEncode) {
+	_ASSERT(tc::equal(tc::make_str(tc::json::encode("")), ""));
+	_ASSERT(tc::equal(tc::make_str(tc::json::encode("abc")), "abc"));
+	_ASSERT(tc::equal(tc::make_str(tc::json::encode("a\"b\\c/d")), "a\\\"b\\\\c/d"));
+	_ASSERT(tc::equal(tc::make_str(tc::json::encode("\b\f\n\r\t\x01\x1f\x7f")), "\\b\\f\\n\\r\\t\\u0001\\u001f\x7f"));
+	_ASSERT(tc::equal(tc::make_str(tc::json::encode("\xE2\x82\xAC")), "\xE2\x82\xAC")); // UTF-8 is not escaped
+	_ASSERT(tc::equal(tc::make_str(tc::json::encode(tc::transform(tc::make_str("x\n\"y"), tc::identity()))), "x\\n\\\"y")); // not contiguous
+	_ASSERT(tc::equal(tc::make_str<char16_t>(tc::json::encode(u"€\n")), u"€\\n"));
+
+	// Round trip of random strings, long enough for vectorized scanning.
+	std::mt19937 gen(42);
+	for (int i = 0; i < 1000; ++i) {
+		tc::string<char> str;
+		auto const n = std::uniform_int_distribution<int>(0, 200)(gen);
+		for (int j = 0; j < n; ++j) {
+			tc::cont_emplace_back(str, static_cast<char>(0 == std::uniform_int_distribution<int>(0, 15)(gen) ? std::uniform_int_distribution<int>(0, 0x7f)(gen) : std::uniform_int_distribution<int>(0x20, 0x7e)(gen)));
+		}
+		auto const strJson = tc::make_str<char>("\"", tc::json::encode(str), "\"");
+		tc::json::parser parser(strJson, tc::json::simple_error_handler(tc::never_called()));
+		_ASSERT(tc::equal(parser.expect_string(), str));
+		parser.expect_end();
+	}
+}
+
+UNITTESTDEF(JSONWriter) {
+	{
+		tc::string<char> str;
+		tc::json::writer writer(tc::appender(str));
+		writer.begin_object();
+		writer.key("a");
+		writer.begin_array();
+		writer.number(1);
+		writer.number(-2.5);
+		writer.number(0.1);
+		writer.number(1e300);
+		writer.null();
+		writer.boolean(true);
+		writer.begin_object();
+		writer.end_object();
+		writer.begin_array();
+		writer.end_array();
+		writer.end_array();
+		writer.key("b\n");
+		writer.string("\"x\"");
+		writer.key("c");
+		writer.number("1.50");
+		writer.end_object();
+		_ASSERTPRINT(tc::equal(str, R"({"a":[1,-2.5,0.1,1e+300,null,true,{},[]],"b\n":"\"x\"","c":1.50})"), str);
+	}
+	{
+		// Shortest round trip of random doubles.
+		std::mt19937_64 gen(42);
+		for (int i = 0; i < 10000; ++i) {
+			auto const f = tc::bit_cast<double>(gen());
+			if (!std::isfinite(f)) continue;
+			tc::string<char> str;
+			tc::json::writer writer(tc::appender(str));
+			writer.number(f);
+			_ASSERTEQUAL(tc::bit_cast<std::uint64_t>(*tc::number_from_json_string<double>(str)), tc::bit_cast<std::uint64_t>(f));
+		}
+	}
+	{
+		// The writer is a handler of the push parser, which minifies the input.
+		tc::string<char> str;
+		tc::json::push_parser<char, tc::json::writer<tc::appender_type<tc::string<char>>>, tc::decay_t<decltype(tc::json::assert_and_throw<int>)>> parser(
+			tc::json::writer(tc::appender(str)),
+			tc::json::assert_and_throw<int>
+		);
+		parser.push(tc::make_str(" { \"a\\u0041\" : [ 1.0e5 , true , \"\\/\" ] , \"b\" : null } "));
+		parser.finish();
+		_ASSERTPRINT(tc::equal(str, R"({"aA":[1.0e5,true,"/"],"b":null})"), str);
+	}
+}
@@ -0,0 +1,137 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "parse_number.h"
+#include "../range/transform_adaptor.h"
+#include "../algorithm/append.h"
+#include "format.h"
+#include "make_c_str.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+	template<typename T>
+	T strto(char const* const sz) noexcept {
+		if constexpr (std::is_same<T, float>::value) {
+			return std::strtof(sz, nullptr);
+		} else {
+			return std::strtod(sz, nullptr);
+		}
+	}
+
+	template<typename T>
+	void CheckAgainstStrtod(tc::string<char> const& str) noexcept {
+		auto const tExpected = strto<T>(tc::as_c_str(str));
+		auto const CheckEqual = [&](T const t) noexcept {
+			_ASSERTPRINT(tc::bit_cast<typename tc::parse_number_detail::binary_format<T>::bits_t>(t) == tc::bit_cast<typename tc::parse_number_detail::binary_format<T>::bits_t>(tExpected), str);
+		};
+		CheckEqual(*tc::number_from_json_string<T>(str));
+		CheckEqual(*tc::number_from_json_string<T>(tc::transform(str, tc::identity()))); // not contiguous
+		CheckEqual(tc::parse_number_detail::float_from_json_slow<T>(tc::begin(str), tc::end(str)));
+	}
+
+	template<typename T>
+	void CheckRandomNumbers() noexcept {
+		std::mt19937_64 gen(42);
+		auto const Random = [&](int const nMin, int const nMax) noexcept {
+			return std::uniform_int_distribution<int>(nMin, nMax)(gen);
+		};
+		char ach[64];
+		for (int i = 0; i < 20000; ++i) {
+			// Round trips of random bit patterns, including subnormals.
+			auto const t = tc::bit_cast<T>(static_cast<typename tc::parse_number_detail::binary_format<T>::bits_t>(gen()));
+			if (!std::isfinite(t)) continue;
+			std::snprintf(ach, std::size(ach), "%.*e", Random(0, std::numeric_limits<T>::max_digits10), static_cast<double>(t));
+			CheckAgainstStrtod<T>(tc::make_str(tc::as_c_str(ach)));
+		}
+		for (int i = 0; i < 20000; ++i) {
+			// Random digit strings, also longer than 19 digits.
+			tc::string<char> str;
+			if (0 == Random(0, 1)) tc::append(str, "-");
+			auto const nDigits = Random(1, 30);
+			tc::cont_emplace_back(str, static_cast<char>('1' + Random(0, 8)));
+			for (int j = 1; j < nDigits; ++j) {
+				tc::cont_emplace_back(str, static_cast<char>('0' + (0 == Random(0, 3) ? 0 : Random(0, 9))));
+			}
+			if (0 == Random(0, 1)) {
+				tc::append(str, ".", tc::as_dec(Random(0, 99999)));
+			}
+			if (0 == Random(0, 1)) {
+				tc::append(str, "e", tc::as_dec(Random(-std::numeric_limits<T>::max_exponent10 - 40, std::numeric_limits<T>::max_exponent10 + 10)));
+			}
+			CheckAgainstStrtod<T>(str);
+		}
+	}
+}
+
+UNITTESTDEF(number_from_json_string_float) {
+	for (auto const sz : {
+		"0", "-0", "0.0", "0e5", "1", "-1", "0.1", "123.456", "1E+2", "1e-2", "0.000001234",
+		"9007199254740993", "9007199254740993.0000000001", "18014398509481989", // halfway between doubles
+		"1e22", "1e23", "7.2057594037927933e16",
+		"1.7976931348623157e308", "1.7976931348623158e308", "1.7976931348623159e308", "1e309", "1e99999999999999999999",
+		"2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-99999999999999999999",
+		"3.4028234663852886e38", "3.4028235677973366e38", "1.4012984643e-45", "7.0064923216240854e-46", "16777217",
+		"3.14159265358979323846264338327950288419716939937510582097494459230781640628620899862803482534211706798214808651",
+		"0.00000000000000000000000000000000000000000000000000000000000000000000000000000000000000001"
+	}) {
+		CheckAgainstStrtod<double>(tc::make_str(sz));
+		CheckAgainstStrtod<float>(tc::make_str(sz));
+	}
+	CheckRandomNumbers<double>();
+	CheckRandomNumbers<float>();
+}
+
+UNITTESTDEF(number_from_json_string_integer) {
+	_ASSERTEQUAL(*tc::number_from_json_string<int>("0"), 0);
+	_ASSERTEQUAL(*tc::number_from_json_string<int>("-0"), 0);
+	_ASSERTEQUAL(*tc::number_from_json_string<int>("-2147483648"), std::numeric_limits<int>::lowest());
+	_ASSERTEQUAL(*tc::number_from_json_string<int>("2147483647"), std::numeric_limits<int>::max());
+	_ASSERT(!tc::number_from_json_string<int>("2147483648"));
+	_ASSERT(!tc::number_from_json_string<int>("-2147483649"));
+	_ASSERTEQUAL(*tc::number_from_json_string<std::int64_t>("-9223372036854775808"), std::numeric_limits<std::int64_t>::lowest());
+	_ASSERTEQUAL(*tc::number_from_json_string<std::int64_t>("1234567890123456789"), 1234567890123456789);
+	_ASSERTEQUAL(*tc::number_from_json_string<std::uint64_t>("18446744073709551615"), std::numeric_limits<std::uint64_t>::max());
+	_ASSERT(!tc::number_from_json_string<std::uint64_t>("18446744073709551616"));
+	_ASSERT(!tc::number_from_json_string<std::uint64_t>("99999999999999999999"));
+	_ASSERT(!tc::number_from_json_string<std::uint64_t>("123456789012345678901234567890"));
+	_ASSERTEQUAL(*tc::number_from_json_string<unsigned int>("-0"), 0u);
+	_ASSERT(!tc::number_from_json_string<unsigned int>("-1"));
+	_ASSERTEQUAL(*tc::number_from_json_string<std::uint8_t>("255"), 255);
+	_ASSERT(!tc::number_from_json_string<std::uint8_t>("256"));
+	_ASSERT(!tc::number_from_json_string<int>("1.0"));
+	_ASSERT(!tc::number_from_json_string<int>("1e2"));
+	_ASSERT(!tc::number_from_json_string<int>("123456789.5"));
+	_ASSERTEQUAL(*tc::number_from_json_string<std::int64_t>(tc::transform(tc::make_str("-98765432109876"), tc::identity())), -98765432109876); // not contiguous
+
+	std::mt19937_64 gen(42);
+	for (int i = 0; i < 10000; ++i) {
+		auto const n = static_cast<std::int64_t>(gen() >> std::uniform_int_distribution<int>(0, 63)(gen));
+		_ASSERTEQUAL(*tc::number_from_json_string<std::int64_t>(tc::make_str<char>(tc::as_dec(n))), n);
+		_ASSERTEQUAL(*tc::number_from_json_string<std::int64_t>(tc::make_str<char>(tc::as_dec(-n))), -n);
+	}
+}
+
+UNITTESTDEF(swar_eight_digits) {
+	for (auto const sz : {"00000000", "12345678", "99999999", "90000009"}) {
+		std::uint64_t n;
+		std::memcpy(std::addressof(n), sz, sizeof(n));
+		if constexpr (std::endian::little == std::endian::native) {
+			_ASSERT(tc::swar_detail::is_eight_digits(n));
+			_ASSERTEQUAL(tc::swar_detail::eight_digits_value(n), static_cast<std::uint32_t>(std::strtoul(sz, nullptr, 10)));
+		}
+	}
+	for (auto const sz : {"1234567/", "1234567:", "a2345678", "1234 678", "\xF9" "2345678", "12345\xC0" "78"}) {
+		std::uint64_t n;
+		std::memcpy(std::addressof(n), sz, sizeof(n));
+		_ASSERT(!tc::swar_detail::is_eight_digits(n));
+	}
+}
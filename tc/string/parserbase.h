@@ -12,6 +12,7 @@
 #include "../range/meta.h"
 #include "char.h"
 #include "ascii.h"
+#include "simd.h"
 
 namespace tc {
 	namespace no_adl {
@@ -185,37 +186,44 @@ namespace tc {
 
 		protected:
 			void skip_whitespace() & MAYTHROW {
-				_ASSERTDEBUG(*this);
-				for (;;) {
-					expect_not_end(); // MAYTHROW
-					switch(*m_itchInput) {
-					default:
-						return;
-					case '\t':
-					case '\n':
-					case '\r':
-					case ' ':
-						++m_itchInput;
-						break;
-					}
-				}
+				skip_whitespace_maybe_end();
+				expect_not_end(); // MAYTHROW
 			}
 			void skip_whitespace_maybe_end() & noexcept {
 				_ASSERTDEBUG(*this);
-				while (m_itchInput != m_end) {
-					switch(*m_itchInput) {
-					default:
-						return;
-					case '\t':
-					case '\n':
-					case '\r':
-					case ' ':
+				if constexpr (c_bVectorizableFind) {
+					// Most runs of whitespace are a single space or line break, only indentation is worth a vectorized search.
+					for (int i = 0; i < 2; ++i) {
+						if (m_itchInput == m_end || !is_whitespace(*m_itchInput)) return;
+						++m_itchInput;
+					}
+					auto const pch = std::to_address(m_itchInput);
+					m_itchInput += tc::simd::find_first_not_of<whitespace>(pch, std::to_address(m_end)) - pch;
+				} else {
+					while (m_itchInput != m_end && is_whitespace(*m_itchInput)) {
 						++m_itchInput;
-						break;
 					}
 				}
 			}
 
+			using whitespace = tc::simd::any_of<'\t', '\n', '\r', ' '>;
+			static constexpr bool is_whitespace(char_type const ch) noexcept {
+				switch(ch) {
+				default:
+					return false;
+				case '\t':
+				case '\n':
+				case '\r':
+				case ' ':
+					return true;
+				}
+			}
+
+			// Contiguous input of 1 or 2 byte code units can be searched a whole vector at a time, see simd.h.
+			static constexpr bool c_bVectorizableFind = sizeof(char_type) <= 2 && tc::contiguous_range<String> && tc::common_range<String>;
+			// Block classification and UTF-8 validation need 1 byte code units.
+			static constexpr bool c_bVectorizable = sizeof(char_type) == 1 && c_bVectorizableFind;
+
 			// Precondition: We've already consumed one character and want to skip the rest of the code point.
 			void skip_utf8_code_point(char_type const ch0) & MAYTHROW requires (sizeof(char_type) == 1) {
 				_ASSERTDEBUG(*this);
@@ -263,6 +271,26 @@ namespace tc {
 				}
 			}
 
+			// Advances to the next code unit contained in CodeUnitSet, which must only contain ASCII, or to the end. The code units in between must be valid UTF-8.
+			// Contiguous input takes two vectorized passes: the first finds the end of the run, the second validates the run.
+			template<typename CodeUnitSet>
+			void skip_utf8_until() & MAYTHROW requires (sizeof(char_type) == 1) {
+				_ASSERTDEBUG(*this);
+				if constexpr (c_bVectorizable) {
+					auto const pch = std::to_address(m_itchInput);
+					auto const pchUntil = tc::simd::find_first_of<CodeUnitSet>(pch, std::to_address(m_end));
+					auto const pchInvalid = tc::simd::find_first_invalid_utf8(pch, pchUntil);
+					m_itchInput += pchInvalid - pch;
+					if (pchUntil != pchInvalid) {
+						this->template error<tc_mem_fn(.invalid_encoding)>(); // MAYTHROW
+					}
+				} else {
+					while (m_itchInput != m_end && !CodeUnitSet::contains(*m_itchInput)) {
+						skip_utf8_code_point(*m_itchInput++); // MAYTHROW
+					}
+				}
+			}
+
 		protected: // TODO: refactor XML parser
 			tc::reference_or_value<String> m_strInput;
 			iterator m_itchInput;
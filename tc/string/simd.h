@@ -0,0 +1,600 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/bitfield.h"
+#include "../base/enum.h"
+
+#include <boost/predef/architecture.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#if BOOST_ARCH_X86
+# define TC_SIMD 1
+# include <immintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+#  define TC_SIMD_TARGET(isa) // MSVC allows intrinsics of any instruction set in any function
+# else
+#  define TC_SIMD_TARGET(isa) [[gnu::target(isa)]]
+# endif
+#elif BOOST_ARCH_ARM
+# define TC_SIMD 1
+# ifdef TC_WIN
+#  include <arm64_neon.h> // https://developercommunity.visualstudio.com/t/ARM64EC-should-be-considered-in-arm_neon/1477300
+# else
+#  include <arm_neon.h>
+# endif
+#else
+# define TC_SIMD 0
+#endif
+
+#ifdef _MSC_VER
+# define TC_SIMD_FORCEINLINE TC_FORCEINLINE
+#else
+# define TC_SIMD_FORCEINLINE [[gnu::always_inline]] // TC_FORCEINLINE adds gnu::nodebug, which only clang knows
+#endif
+
+namespace tc::simd {
+#if BOOST_ARCH_X86
+	// SSE2 is part of x86-64, wider vectors are selected at runtime.
+	TC_DEFINE_ENUM(ESimdLevel, esimdlevel, (SSE2)(AVX2)(AVX512))
+
+	inline ESimdLevel supported_simd_level() noexcept {
+		static ESimdLevel const s_esimdlevel = []() noexcept {
+		#ifdef _MSC_VER
+			int anCpuInfo[4];
+			__cpuid(anCpuInfo, 0);
+			if (anCpuInfo[0] < 7) return esimdlevelSSE2;
+			__cpuid(anCpuInfo, 1);
+			if (0 == (anCpuInfo[2] & (1 << 27))) return esimdlevelSSE2; // OSXSAVE
+			auto const nXcr0 = _xgetbv(0);
+			__cpuidex(anCpuInfo, 7, 0);
+			if (0xE6 == (nXcr0 & 0xE6) && 0 != (anCpuInfo[1] & (1 << 16)) && 0 != (anCpuInfo[1] & (1 << 30))) return esimdlevelAVX512; // OS saves ZMM state, AVX512F, AVX512BW
+			if (0x6 == (nXcr0 & 0x6) && 0 != (anCpuInfo[1] & (1 << 5))) return esimdlevelAVX2; // OS saves YMM state, AVX2
+			return esimdlevelSSE2;
+		#else
+			__builtin_cpu_init(); // may run before constructors of libgcc
+			if (__builtin_cpu_supports("avx512bw")) return esimdlevelAVX512;
+			if (__builtin_cpu_supports("avx2")) return esimdlevelAVX2;
+			return esimdlevelSSE2;
+		#endif
+		}();
+		return s_esimdlevel;
+	}
+#endif
+
+	namespace no_adl {
+		// Set of code units that can be searched for a whole vector at a time:
+		// code units equal to one of ns, code units less than nLess and code units greater than nGreater (unsigned comparisons).
+		// Code units are 1 or 2 bytes wide.
+		template<unsigned int nLess, unsigned int nGreater, unsigned int... ns>
+		struct code_unit_set final {
+			template<typename Char>
+			static constexpr bool contains(Char const ch) noexcept {
+				auto const n = static_cast<std::make_unsigned_t<Char>>(ch);
+				return n < nLess || nGreater < n || ((ns == n) || ...);
+			}
+
+		private:
+			template<typename Char>
+			static constexpr bool c_bLess = 0 < nLess;
+			template<typename Char>
+			static constexpr bool c_bGreater = nGreater < std::numeric_limits<std::make_unsigned_t<Char>>::max();
+			// For bytes, "less than nLess or non-ASCII" is a single signed comparison.
+			template<typename Char>
+			static constexpr bool c_bLessOrNonAscii = 1 == sizeof(Char) && 0x7F == nGreater && 0 < nLess && nLess <= 0x7F;
+
+		public:
+#if BOOST_ARCH_X86
+			template<typename Char>
+			TC_SIMD_FORCEINLINE static __m128i matches_sse2(__m128i const m128) noexcept {
+				auto m128Result = _mm_setzero_si128();
+				if constexpr (1 == sizeof(Char)) {
+					((m128Result = _mm_or_si128(m128Result, _mm_cmpeq_epi8(m128, _mm_set1_epi8(static_cast<char>(ns))))), ...);
+					if constexpr (c_bLessOrNonAscii<Char>) {
+						m128Result = _mm_or_si128(m128Result, _mm_cmplt_epi8(m128, _mm_set1_epi8(nLess)));
+					} else {
+						if constexpr (c_bLess<Char>) m128Result = _mm_or_si128(m128Result, _mm_cmpeq_epi8(_mm_min_epu8(m128, _mm_set1_epi8(static_cast<char>(nLess - 1))), m128));
+						if constexpr (c_bGreater<Char>) m128Result = _mm_or_si128(m128Result, _mm_cmpeq_epi8(_mm_max_epu8(m128, _mm_set1_epi8(static_cast<char>(nGreater + 1))), m128));
+					}
+				} else {
+					static_assert(2 == sizeof(Char));
+					((m128Result = _mm_or_si128(m128Result, _mm_cmpeq_epi16(m128, _mm_set1_epi16(static_cast<short>(ns))))), ...);
+					// SSE2 has no unsigned 16 bit comparisons: flip the sign bits and compare signed.
+					auto const m128Biased = _mm_xor_si128(m128, _mm_set1_epi16(static_cast<short>(0x8000)));
+					if constexpr (c_bLess<Char>) m128Result = _mm_or_si128(m128Result, _mm_cmplt_epi16(m128Biased, _mm_set1_epi16(static_cast<short>(nLess ^ 0x8000))));
+					if constexpr (c_bGreater<Char>) m128Result = _mm_or_si128(m128Result, _mm_cmpgt_epi16(m128Biased, _mm_set1_epi16(static_cast<short>(nGreater ^ 0x8000))));
+				}
+				return m128Result;
+			}
+
+			template<typename Char>
+			TC_SIMD_FORCEINLINE TC_SIMD_TARGET("avx2") static __m256i matches_avx2(__m256i const m256) noexcept {
+				auto m256Result = _mm256_setzero_si256();
+				if constexpr (1 == sizeof(Char)) {
+					((m256Result = _mm256_or_si256(m256Result, _mm256_cmpeq_epi8(m256, _mm256_set1_epi8(static_cast<char>(ns))))), ...);
+					if constexpr (c_bLessOrNonAscii<Char>) {
+						m256Result = _mm256_or_si256(m256Result, _mm256_cmpgt_epi8(_mm256_set1_epi8(nLess), m256));
+					} else {
+						if constexpr (c_bLess<Char>) m256Result = _mm256_or_si256(m256Result, _mm256_cmpeq_epi8(_mm256_min_epu8(m256, _mm256_set1_epi8(static_cast<char>(nLess - 1))), m256));
+						if constexpr (c_bGreater<Char>) m256Result = _mm256_or_si256(m256Result, _mm256_cmpeq_epi8(_mm256_max_epu8(m256, _mm256_set1_epi8(static_cast<char>(nGreater + 1))), m256));
+					}
+				} else {
+					static_assert(2 == sizeof(Char));
+					((m256Result = _mm256_or_si256(m256Result, _mm256_cmpeq_epi16(m256, _mm256_set1_epi16(static_cast<short>(ns))))), ...);
+					if constexpr (c_bLess<Char>) m256Result = _mm256_or_si256(m256Result, _mm256_cmpeq_epi16(_mm256_min_epu16(m256, _mm256_set1_epi16(static_cast<short>(nLess - 1))), m256));
+					if constexpr (c_bGreater<Char>) m256Result = _mm256_or_si256(m256Result, _mm256_cmpeq_epi16(_mm256_max_epu16(m256, _mm256_set1_epi16(static_cast<short>(nGreater + 1))), m256));
+				}
+				return m256Result;
+			}
+
+			// One bit per code unit.
+			template<typename Char>
+			TC_SIMD_FORCEINLINE TC_SIMD_TARGET("avx512bw") static std::uint64_t matches_avx512(__m512i const m512) noexcept {
+				std::uint64_t nResult = 0;
+				if constexpr (1 == sizeof(Char)) {
+					((nResult |= _mm512_cmpeq_epi8_mask(m512, _mm512_set1_epi8(static_cast<char>(ns)))), ...);
+					if constexpr (c_bLess<Char>) nResult |= _mm512_cmplt_epu8_mask(m512, _mm512_set1_epi8(static_cast<char>(nLess)));
+					if constexpr (c_bGreater<Char>) nResult |= _mm512_cmpgt_epu8_mask(m512, _mm512_set1_epi8(static_cast<char>(nGreater)));
+				} else {
+					static_assert(2 == sizeof(Char));
+					((nResult |= _mm512_cmpeq_epi16_mask(m512, _mm512_set1_epi16(static_cast<short>(ns)))), ...);
+					if constexpr (c_bLess<Char>) nResult |= _mm512_cmplt_epu16_mask(m512, _mm512_set1_epi16(static_cast<short>(nLess)));
+					if constexpr (c_bGreater<Char>) nResult |= _mm512_cmpgt_epu16_mask(m512, _mm512_set1_epi16(static_cast<short>(nGreater)));
+				}
+				return nResult;
+			}
+#elif BOOST_ARCH_ARM
+			template<typename Char>
+			TC_SIMD_FORCEINLINE static uint8x16_t matches_neon(uint8x16_t const u8x16) noexcept {
+				if constexpr (1 == sizeof(Char)) {
+					auto u8x16Result = vdupq_n_u8(0);
+					((u8x16Result = vorrq_u8(u8x16Result, vceqq_u8(u8x16, vdupq_n_u8(static_cast<std::uint8_t>(ns))))), ...);
+					if constexpr (c_bLess<Char>) u8x16Result = vorrq_u8(u8x16Result, vcltq_u8(u8x16, vdupq_n_u8(static_cast<std::uint8_t>(nLess))));
+					if constexpr (c_bGreater<Char>) u8x16Result = vorrq_u8(u8x16Result, vcgtq_u8(u8x16, vdupq_n_u8(static_cast<std::uint8_t>(nGreater))));
+					return u8x16Result;
+				} else {
+					static_assert(2 == sizeof(Char));
+					auto const u16x8 = vreinterpretq_u16_u8(u8x16);
+					auto u16x8Result = vdupq_n_u16(0);
+					((u16x8Result = vorrq_u16(u16x8Result, vceqq_u16(u16x8, vdupq_n_u16(static_cast<std::uint16_t>(ns))))), ...);
+					if constexpr (c_bLess<Char>) u16x8Result = vorrq_u16(u16x8Result, vcltq_u16(u16x8, vdupq_n_u16(static_cast<std::uint16_t>(nLess))));
+					if constexpr (c_bGreater<Char>) u16x8Result = vorrq_u16(u16x8Result, vcgtq_u16(u16x8, vdupq_n_u16(static_cast<std::uint16_t>(nGreater))));
+					return vreinterpretq_u8_u16(u16x8Result);
+				}
+			}
+#endif
+		};
+
+		template<bool bNegate, typename CodeUnitSet, typename Char>
+		Char const* find_first_scalar(Char const* pch, Char const* const pchEnd) noexcept {
+			for (; pch != pchEnd; ++pch) {
+				if (bNegate != CodeUnitSet::contains(*pch)) break;
+			}
+			return pch;
+		}
+
+#if BOOST_ARCH_X86
+		template<bool bNegate, typename CodeUnitSet, typename Char>
+		Char const* find_first_sse2(Char const* pch, Char const* const pchEnd) noexcept {
+			static auto constexpr c_nCodeUnits = 16 / sizeof(Char);
+			for (; static_cast<std::size_t>(pchEnd - pch) >= c_nCodeUnits; pch += c_nCodeUnits) {
+				auto nMask = static_cast<std::uint32_t>(_mm_movemask_epi8(CodeUnitSet::template matches_sse2<Char>(_mm_loadu_si128(reinterpret_cast<__m128i const*>(pch))))); // one bit per byte
+				if constexpr (bNegate) nMask ^= 0xFFFF;
+				if (0 != nMask) return pch + tc::index_of_least_significant_bit(nMask) / sizeof(Char);
+			}
+			return find_first_scalar<bNegate, CodeUnitSet>(pch, pchEnd);
+		}
+
+		template<bool bNegate, typename CodeUnitSet, typename Char>
+		TC_SIMD_TARGET("avx2") Char const* find_first_avx2(Char const* pch, Char const* const pchEnd) noexcept {
+			static auto constexpr c_nCodeUnits = 32 / sizeof(Char);
+			for (; static_cast<std::size_t>(pchEnd - pch) >= c_nCodeUnits; pch += c_nCodeUnits) {
+				auto nMask = static_cast<std::uint32_t>(_mm256_movemask_epi8(CodeUnitSet::template matches_avx2<Char>(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(pch))))); // one bit per byte
+				if constexpr (bNegate) nMask = ~nMask;
+				if (0 != nMask) return pch + tc::index_of_least_significant_bit(nMask) / sizeof(Char);
+			}
+			return find_first_sse2<bNegate, CodeUnitSet>(pch, pchEnd);
+		}
+
+		template<bool bNegate, typename CodeUnitSet, typename Char>
+		TC_SIMD_TARGET("avx512bw") Char const* find_first_avx512(Char const* pch, Char const* const pchEnd) noexcept {
+			static auto constexpr c_nCodeUnits = 64 / sizeof(Char);
+			for (; static_cast<std::size_t>(pchEnd - pch) >= c_nCodeUnits; pch += c_nCodeUnits) {
+				auto nMask = CodeUnitSet::template matches_avx512<Char>(_mm512_loadu_si512(pch)); // one bit per code unit
+				if constexpr (bNegate) nMask ^= std::numeric_limits<std::uint64_t>::max() >> (64 - c_nCodeUnits);
+				if (0 != nMask) return pch + tc::index_of_least_significant_bit(nMask);
+			}
+			return find_first_avx2<bNegate, CodeUnitSet>(pch, pchEnd);
+		}
+#elif BOOST_ARCH_ARM
+		template<bool bNegate, typename CodeUnitSet, typename Char>
+		Char const* find_first_neon(Char const* pch, Char const* const pchEnd) noexcept {
+			static auto constexpr c_nCodeUnits = 16 / sizeof(Char);
+			for (; static_cast<std::size_t>(pchEnd - pch) >= c_nCodeUnits; pch += c_nCodeUnits) {
+				auto u8x16Matches = CodeUnitSet::template matches_neon<Char>(vld1q_u8(reinterpret_cast<std::uint8_t const*>(pch)));
+				if constexpr (bNegate) u8x16Matches = vmvnq_u8(u8x16Matches);
+				// https://community.arm.com/arm-community-blogs/b/infrastructure-solutions-blog/posts/porting-x86-vector-bitmask-optimizations-to-arm-neon
+				auto const nMask = vget_lane_u64(
+					vreinterpret_u64_u8( // treat 8 bytes as 64 bit word
+						vshrn_n_u16(vreinterpretq_u16_u8(u8x16Matches), 4) // shift 16bit word right by 4, s.t. each byte yields a nibble of the 64 bit word
+					),
+					0
+				); // four bits per byte
+				if (0 != nMask) return pch + tc::index_of_least_significant_bit(nMask) / 4 / sizeof(Char);
+			}
+			return find_first_scalar<bNegate, CodeUnitSet>(pch, pchEnd);
+		}
+#endif
+
+		template<typename... CodeUnitSet>
+		using block_masks_t = std::array<std::uint64_t, sizeof...(CodeUnitSet)>;
+
+#if BOOST_ARCH_X86
+		template<typename... CodeUnitSet, typename Char>
+		block_masks_t<CodeUnitSet...> block_masks_sse2(Char const* const pch) noexcept {
+			block_masks_t<CodeUnitSet...> anMask{};
+			for (int i = 0; i < 4; ++i) {
+				auto const m128 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pch) + i);
+				auto itnMask = anMask.begin();
+				((*itnMask++ |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(CodeUnitSet::template matches_sse2<Char>(m128)))) << (16 * i)), ...);
+			}
+			return anMask;
+		}
+
+		template<typename... CodeUnitSet, typename Char>
+		TC_SIMD_TARGET("avx2") block_masks_t<CodeUnitSet...> block_masks_avx2(Char const* const pch) noexcept {
+			block_masks_t<CodeUnitSet...> anMask{};
+			for (int i = 0; i < 2; ++i) {
+				auto const m256 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(pch) + i);
+				auto itnMask = anMask.begin();
+				((*itnMask++ |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(CodeUnitSet::template matches_avx2<Char>(m256)))) << (32 * i)), ...);
+			}
+			return anMask;
+		}
+
+		template<typename... CodeUnitSet, typename Char>
+		TC_SIMD_TARGET("avx512bw") block_masks_t<CodeUnitSet...> block_masks_avx512(Char const* const pch) noexcept {
+			auto const m512 = _mm512_loadu_si512(pch);
+			return {CodeUnitSet::template matches_avx512<Char>(m512)...};
+		}
+#elif BOOST_ARCH_ARM
+		template<typename... CodeUnitSet, typename Char>
+		block_masks_t<CodeUnitSet...> block_masks_neon(Char const* const pch) noexcept {
+			static constexpr std::uint8_t c_anBit[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+			auto const u8x16Bit = vld1q_u8(c_anBit);
+			auto const movemask = [&](uint8x16_t const u8x16Matches) noexcept {
+				// Sum up the bits of each half vector by pairwise addition.
+				auto u8x16Sum = vandq_u8(u8x16Matches, u8x16Bit);
+				u8x16Sum = vpaddq_u8(u8x16Sum, u8x16Sum);
+				u8x16Sum = vpaddq_u8(u8x16Sum, u8x16Sum);
+				u8x16Sum = vpaddq_u8(u8x16Sum, u8x16Sum);
+				return static_cast<std::uint64_t>(vgetq_lane_u16(vreinterpretq_u16_u8(u8x16Sum), 0));
+			};
+			block_masks_t<CodeUnitSet...> anMask{};
+			for (int i = 0; i < 4; ++i) {
+				auto const u8x16 = vld1q_u8(reinterpret_cast<std::uint8_t const*>(pch) + 16 * i);
+				auto itnMask = anMask.begin();
+				((*itnMask++ |= movemask(CodeUnitSet::template matches_neon<Char>(u8x16)) << (16 * i)), ...);
+			}
+			return anMask;
+		}
+#endif
+
+		template<typename... CodeUnitSet, typename Char>
+		block_masks_t<CodeUnitSet...> block_masks_scalar(Char const* const pch) noexcept {
+			block_masks_t<CodeUnitSet...> anMask{};
+			for (int i = 0; i < 64; ++i) {
+				auto itnMask = anMask.begin();
+				((*itnMask++ |= static_cast<std::uint64_t>(CodeUnitSet::contains(pch[i])) << i), ...);
+			}
+			return anMask;
+		}
+
+		template<bool bNegate, typename CodeUnitSet, typename Char>
+		Char const* find_first(Char const* const pch, Char const* const pchEnd) noexcept {
+			static_assert(1 == sizeof(Char) || 2 == sizeof(Char));
+			_ASSERTDEBUG(pch <= pchEnd);
+#if BOOST_ARCH_X86
+			if (static_cast<std::size_t>(pchEnd - pch) * sizeof(Char) < 32) {
+				// Not worth the dispatch, the result is at most one SSE2 vector away.
+				return find_first_sse2<bNegate, CodeUnitSet>(pch, pchEnd);
+			}
+			switch_no_default(supported_simd_level()) {
+				case esimdlevelAVX512: return find_first_avx512<bNegate, CodeUnitSet>(pch, pchEnd);
+				case esimdlevelAVX2: return find_first_avx2<bNegate, CodeUnitSet>(pch, pchEnd);
+				case esimdlevelSSE2: return find_first_sse2<bNegate, CodeUnitSet>(pch, pchEnd);
+			}
+#elif BOOST_ARCH_ARM
+			return find_first_neon<bNegate, CodeUnitSet>(pch, pchEnd);
+#else
+			return find_first_scalar<bNegate, CodeUnitSet>(pch, pchEnd);
+#endif
+		}
+
+		// Returns the end of the UTF-8 encoded code point at pch, or nullptr if it is ill-formed, see Table 3-7 of https://www.unicode.org/versions/Unicode15.0.0/ch03.pdf#G27506
+		template<typename Char>
+		constexpr Char const* utf8_code_point_end(Char const* const pch, Char const* const pchEnd) noexcept {
+			_ASSERTDEBUG(pch != pchEnd);
+			auto const CodeUnit = [&](std::ptrdiff_t const i) noexcept -> unsigned int {
+				return i < pchEnd - pch ? static_cast<unsigned char>(pch[i]) : 0; // 0 is not a continuation byte
+			};
+			auto const IsContinuation = [](unsigned int const n) noexcept {
+				return 0x80 == (n & 0xC0);
+			};
+			auto const n0 = CodeUnit(0);
+			if (n0 < 0x80) return pch + 1;
+			auto const n1 = CodeUnit(1);
+			if (n0 < 0xC2) { // continuation byte or overlong 2 byte sequence
+				return nullptr;
+			} else if (n0 < 0xE0) {
+				return IsContinuation(n1) ? pch + 2 : nullptr;
+			} else if (n0 < 0xF0) {
+				bool const bValid = IsContinuation(n1) && IsContinuation(CodeUnit(2))
+					&& (0xE0 != n0 || 0xA0 <= n1) // non-shortest form
+					&& (0xED != n0 || n1 < 0xA0); // surrogates
+				return bValid ? pch + 3 : nullptr;
+			} else {
+				bool const bValid = n0 < 0xF5 && IsContinuation(n1) && IsContinuation(CodeUnit(2)) && IsContinuation(CodeUnit(3))
+					&& (0xF0 != n0 || 0x90 <= n1) // non-shortest form
+					&& (0xF4 != n0 || n1 < 0x90); // greater than U+10FFFF
+				return bValid ? pch + 4 : nullptr;
+			}
+		}
+
+		template<typename Char>
+		Char const* find_first_invalid_utf8_scalar(Char const* pch, Char const* const pchEnd) noexcept {
+			while (pch != pchEnd) {
+				auto const pchNext = utf8_code_point_end(pch, pchEnd);
+				if (!pchNext) break;
+				pch = pchNext;
+			}
+			return pch;
+		}
+
+		// Validation of whole vectors by lookup tables: Keiser, Lemire: Validating UTF-8 In Less Than One Instruction Per Byte, https://arxiv.org/abs/2010.03090
+		// Every pair of consecutive bytes is classified by three table lookups, by the high nibble and the low nibble of the first byte
+		// and by the high nibble of the second byte. A bit that is set in all three results is an error, except that the bit for two
+		// continuation bytes in a row must be set exactly where the second byte must continue a 3 or 4 byte sequence.
+		namespace utf8_lookup {
+			inline constexpr std::uint8_t c_nTooShort = 1 << 0; // lead byte not followed by a continuation byte
+			inline constexpr std::uint8_t c_nTooLong = 1 << 1; // ASCII byte followed by a continuation byte
+			inline constexpr std::uint8_t c_nOverlong3 = 1 << 2;
+			inline constexpr std::uint8_t c_nTooLarge = 1 << 3;
+			inline constexpr std::uint8_t c_nSurrogate = 1 << 4;
+			inline constexpr std::uint8_t c_nOverlong2 = 1 << 5;
+			inline constexpr std::uint8_t c_nTooLarge1000 = 1 << 6;
+			inline constexpr std::uint8_t c_nOverlong4 = 1 << 6;
+			inline constexpr std::uint8_t c_nTwoContinuations = 1 << 7;
+			inline constexpr std::uint8_t c_nCarry = c_nTooShort | c_nTooLong | c_nTwoContinuations;
+
+			alignas(16) inline constexpr std::array<std::uint8_t, 16> c_anByte1High = {
+				c_nTooLong, c_nTooLong, c_nTooLong, c_nTooLong, c_nTooLong, c_nTooLong, c_nTooLong, c_nTooLong, // 0_______
+				c_nTwoContinuations, c_nTwoContinuations, c_nTwoContinuations, c_nTwoContinuations, // 10______
+				c_nTooShort | c_nOverlong2, // 1100____
+				c_nTooShort, // 1101____
+				c_nTooShort | c_nOverlong3 | c_nSurrogate, // 1110____
+				c_nTooShort | c_nTooLarge | c_nTooLarge1000 | c_nOverlong4 // 1111____
+			};
+			alignas(16) inline constexpr std::array<std::uint8_t, 16> c_anByte1Low = {
+				c_nCarry | c_nOverlong3 | c_nOverlong2 | c_nOverlong4, // ____0000
+				c_nCarry | c_nOverlong2, // ____0001
+				c_nCarry, c_nCarry, // ____001_
+				c_nCarry | c_nTooLarge, // ____0100
+				c_nCarry | c_nTooLarge | c_nTooLarge1000, c_nCarry | c_nTooLarge | c_nTooLarge1000, c_nCarry | c_nTooLarge | c_nTooLarge1000, // ____0101, ____011_
+				c_nCarry | c_nTooLarge | c_nTooLarge1000, c_nCarry | c_nTooLarge | c_nTooLarge1000, c_nCarry | c_nTooLarge | c_nTooLarge1000, c_nCarry | c_nTooLarge | c_nTooLarge1000, // ____10__
+				c_nCarry | c_nTooLarge | c_nTooLarge1000, // ____1100
+				c_nCarry | c_nTooLarge | c_nTooLarge1000 | c_nSurrogate, // ____1101
+				c_nCarry | c_nTooLarge | c_nTooLarge1000, c_nCarry | c_nTooLarge | c_nTooLarge1000 // ____111_
+			};
+			alignas(16) inline constexpr std::array<std::uint8_t, 16> c_anByte2High = {
+				c_nTooShort, c_nTooShort, c_nTooShort, c_nTooShort, c_nTooShort, c_nTooShort, c_nTooShort, c_nTooShort, // 0_______
+				c_nTooLong | c_nOverlong2 | c_nTwoContinuations | c_nOverlong3 | c_nTooLarge1000 | c_nOverlong4, // 1000____
+				c_nTooLong | c_nOverlong2 | c_nTwoContinuations | c_nOverlong3 | c_nTooLarge, // 1001____
+				c_nTooLong | c_nOverlong2 | c_nTwoContinuations | c_nSurrogate | c_nTooLarge, c_nTooLong | c_nOverlong2 | c_nTwoContinuations | c_nSurrogate | c_nTooLarge, // 101_____
+				c_nTooShort, c_nTooShort, c_nTooShort, c_nTooShort // 11______
+			};
+
+			// Subtracted with saturation from the last bytes of a vector, non-zero iff they begin a sequence that does not end in the vector.
+			template<std::size_t nBytes>
+			alignas(nBytes) inline constexpr auto c_anIncompleteMax = []() noexcept {
+				std::array<std::uint8_t, nBytes> an;
+				for (auto& n : an) n = 0xFF;
+				an[nBytes - 3] = 0xF0 - 1;
+				an[nBytes - 2] = 0xE0 - 1;
+				an[nBytes - 1] = 0xC0 - 1;
+				return an;
+			}();
+		}
+
+#if BOOST_ARCH_X86
+		// Skips ASCII a vector at a time, but SSE2 has no byte shuffles for the lookup tables.
+		template<typename Char>
+		Char const* find_first_invalid_utf8_sse2(Char const* pch, Char const* const pchEnd) noexcept {
+			for (;;) {
+				pch = find_first_sse2</*bNegate*/false, code_unit_set<0, 0x7F>>(pch, pchEnd);
+				if (pchEnd == pch) return pch;
+				auto const pchNext = utf8_code_point_end(pch, pchEnd);
+				if (!pchNext) return pch;
+				pch = pchNext;
+			}
+		}
+
+		struct SUtf8ValidatorAvx2 final {
+			TC_SIMD_FORCEINLINE TC_SIMD_TARGET("avx2") SUtf8ValidatorAvx2() noexcept
+				: m_m256Error(_mm256_setzero_si256())
+				, m_m256Prev(_mm256_setzero_si256())
+				, m_m256Incomplete(_mm256_setzero_si256())
+			{}
+
+			TC_SIMD_FORCEINLINE TC_SIMD_TARGET("avx2") static __m256i lookup(std::array<std::uint8_t, 16> const& an, __m256i const m256Nibbles) noexcept {
+				return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<__m128i const*>(an.data()))), m256Nibbles);
+			}
+
+			TC_SIMD_FORCEINLINE TC_SIMD_TARGET("avx2") void check(__m256i const m256) & noexcept {
+				if (0 == _mm256_movemask_epi8(m256)) {
+					// ASCII: the only possible error is a sequence that began in the previous vector.
+					m_m256Error = _mm256_or_si256(m_m256Error, m_m256Incomplete);
+					m_m256Incomplete = _mm256_setzero_si256();
+				} else {
+					auto const m256Nibble = _mm256_set1_epi8(0x0F);
+					auto const m256PrevHigh = _mm256_permute2x128_si256(m_m256Prev, m256, 0x21); // bytes 16-31 of m_m256Prev, bytes 0-15 of m256
+					auto const m256Prev1 = _mm256_alignr_epi8(m256, m256PrevHigh, 15);
+					auto const m256Special = _mm256_and_si256(
+						_mm256_and_si256(
+							lookup(utf8_lookup::c_anByte1High, _mm256_and_si256(_mm256_srli_epi16(m256Prev1, 4), m256Nibble)),
+							lookup(utf8_lookup::c_anByte1Low, _mm256_and_si256(m256Prev1, m256Nibble))
+						),
+						lookup(utf8_lookup::c_anByte2High, _mm256_and_si256(_mm256_srli_epi16(m256, 4), m256Nibble))
+					);
+					// The high bit is set iff the byte 2 or 3 positions before begins a 3 or 4 byte sequence, respectively.
+					auto const m256MustContinue = _mm256_or_si256(
+						_mm256_subs_epu8(_mm256_alignr_epi8(m256, m256PrevHigh, 14), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+						_mm256_subs_epu8(_mm256_alignr_epi8(m256, m256PrevHigh, 13), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)))
+					);
+					m_m256Error = _mm256_or_si256(m_m256Error, _mm256_xor_si256(_mm256_and_si256(m256MustContinue, _mm256_set1_epi8(static_cast<char>(0x80))), m256Special));
+					m_m256Incomplete = _mm256_subs_epu8(m256, _mm256_load_si256(reinterpret_cast<__m256i const*>(utf8_lookup::c_anIncompleteMax<32>.data())));
+				}
+				m_m256Prev = m256;
+			}
+
+			TC_SIMD_FORCEINLINE TC_SIMD_TARGET("avx2") bool valid() const& noexcept {
+				auto const m256Error = _mm256_or_si256(m_m256Error, m_m256Incomplete);
+				return _mm256_testz_si256(m256Error, m256Error);
+			}
+
+			__m256i m_m256Error;
+			__m256i m_m256Prev;
+			__m256i m_m256Incomplete;
+		};
+
+		template<typename Char>
+		TC_SIMD_TARGET("avx2") bool is_valid_utf8_avx2(Char const* pch, Char const* const pchEnd) noexcept {
+			SUtf8ValidatorAvx2 validator;
+			for (; 32 <= pchEnd - pch; pch += 32) {
+				validator.check(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(pch)));
+			}
+			if (pch != pchEnd) {
+				alignas(32) std::array<Char, 32> ach{}; // padded with ASCII
+				std::memcpy(ach.data(), pch, pchEnd - pch);
+				validator.check(_mm256_load_si256(reinterpret_cast<__m256i const*>(ach.data())));
+			}
+			return validator.valid();
+		}
+#elif BOOST_ARCH_ARM
+		struct SUtf8ValidatorNeon final {
+			TC_SIMD_FORCEINLINE void check(uint8x16_t const u8x16) & noexcept {
+				if (vmaxvq_u8(u8x16) < 0x80) {
+					// ASCII: the only possible error is a sequence that began in the previous vector.
+					m_u8x16Error = vorrq_u8(m_u8x16Error, m_u8x16Incomplete);
+					m_u8x16Incomplete = vdupq_n_u8(0);
+				} else {
+					auto const u8x16Nibble = vdupq_n_u8(0x0F);
+					auto const u8x16Prev1 = vextq_u8(m_u8x16Prev, u8x16, 15);
+					auto const u8x16Special = vandq_u8(
+						vandq_u8(
+							vqtbl1q_u8(vld1q_u8(utf8_lookup::c_anByte1High.data()), vshrq_n_u8(u8x16Prev1, 4)),
+							vqtbl1q_u8(vld1q_u8(utf8_lookup::c_anByte1Low.data()), vandq_u8(u8x16Prev1, u8x16Nibble))
+						),
+						vqtbl1q_u8(vld1q_u8(utf8_lookup::c_anByte2High.data()), vshrq_n_u8(u8x16, 4))
+					);
+					// The high bit is set iff the byte 2 or 3 positions before begins a 3 or 4 byte sequence, respectively.
+					auto const u8x16MustContinue = vorrq_u8(
+						vqsubq_u8(vextq_u8(m_u8x16Prev, u8x16, 14), vdupq_n_u8(0xE0 - 0x80)),
+						vqsubq_u8(vextq_u8(m_u8x16Prev, u8x16, 13), vdupq_n_u8(0xF0 - 0x80))
+					);
+					m_u8x16Error = vorrq_u8(m_u8x16Error, veorq_u8(vandq_u8(u8x16MustContinue, vdupq_n_u8(0x80)), u8x16Special));
+					m_u8x16Incomplete = vqsubq_u8(u8x16, vld1q_u8(utf8_lookup::c_anIncompleteMax<16>.data()));
+				}
+				m_u8x16Prev = u8x16;
+			}
+
+			TC_SIMD_FORCEINLINE bool valid() const& noexcept {
+				return 0 == vmaxvq_u8(vorrq_u8(m_u8x16Error, m_u8x16Incomplete));
+			}
+
+			uint8x16_t m_u8x16Error = vdupq_n_u8(0);
+			uint8x16_t m_u8x16Prev = vdupq_n_u8(0);
+			uint8x16_t m_u8x16Incomplete = vdupq_n_u8(0);
+		};
+
+		template<typename Char>
+		bool is_valid_utf8_neon(Char const* pch, Char const* const pchEnd) noexcept {
+			SUtf8ValidatorNeon validator;
+			for (; 16 <= pchEnd - pch; pch += 16) {
+				validator.check(vld1q_u8(reinterpret_cast<std::uint8_t const*>(pch)));
+			}
+			if (pch != pchEnd) {
+				std::array<Char, 16> ach{}; // padded with ASCII
+				std::memcpy(ach.data(), pch, pchEnd - pch);
+				validator.check(vld1q_u8(reinterpret_cast<std::uint8_t const*>(ach.data())));
+			}
+			return validator.valid();
+		}
+#endif
+	}
+	using no_adl::code_unit_set;
+
+	template<unsigned int... ns>
+	using any_of = code_unit_set<0, std::numeric_limits<unsigned int>::max(), ns...>;
+
+	// Classifies the 64 1-byte code units at pch: bit i of the n-th result is set iff pch[i] is contained in the n-th CodeUnitSet.
+	template<typename... CodeUnitSet, typename Char>
+	no_adl::block_masks_t<CodeUnitSet...> block_masks(Char const* const pch) noexcept {
+		static_assert(1 == sizeof(Char));
+#if BOOST_ARCH_X86
+		switch_no_default(supported_simd_level()) {
+			case esimdlevelAVX512: return no_adl::block_masks_avx512<CodeUnitSet...>(pch);
+			case esimdlevelAVX2: return no_adl::block_masks_avx2<CodeUnitSet...>(pch);
+			case esimdlevelSSE2: return no_adl::block_masks_sse2<CodeUnitSet...>(pch);
+		}
+#elif BOOST_ARCH_ARM
+		return no_adl::block_masks_neon<CodeUnitSet...>(pch);
+#else
+		return no_adl::block_masks_scalar<CodeUnitSet...>(pch);
+#endif
+	}
+
+	// Returns pointer to the first code unit in [pch, pchEnd) contained in CodeUnitSet, or pchEnd.
+	template<typename CodeUnitSet, typename Char>
+	Char const* find_first_of(Char const* const pch, Char const* const pchEnd) noexcept {
+		return no_adl::find_first</*bNegate*/false, CodeUnitSet>(pch, pchEnd);
+	}
+
+	// Returns pointer to the first code unit in [pch, pchEnd) not contained in CodeUnitSet, or pchEnd.
+	template<typename CodeUnitSet, typename Char>
+	Char const* find_first_not_of(Char const* const pch, Char const* const pchEnd) noexcept {
+		return no_adl::find_first</*bNegate*/true, CodeUnitSet>(pch, pchEnd);
+	}
+
+	// Returns pointer to the first code unit in [pch, pchEnd) that is not part of a well-formed UTF-8 sequence, or pchEnd.
+	// Valid input is checked a whole vector at a time, only the position of an error is searched for one code point at a time.
+	template<typename Char>
+	Char const* find_first_invalid_utf8(Char const* const pch, Char const* const pchEnd) noexcept {
+		static_assert(1 == sizeof(Char));
+		_ASSERTDEBUG(pch <= pchEnd);
+#if BOOST_ARCH_X86
+		switch_no_default(supported_simd_level()) {
+			case esimdlevelAVX512:
+			case esimdlevelAVX2:
+				if (no_adl::is_valid_utf8_avx2(pch, pchEnd)) return pchEnd;
+				break;
+			case esimdlevelSSE2:
+				return no_adl::find_first_invalid_utf8_sse2(pch, pchEnd);
+		}
+#elif BOOST_ARCH_ARM
+		if (no_adl::is_valid_utf8_neon(pch, pchEnd)) return pchEnd;
+#endif
+		return no_adl::find_first_invalid_utf8_scalar(pch, pchEnd);
+	}
+}
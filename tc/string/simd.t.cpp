@@ -0,0 +1,147 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "simd.h"
+#include "../container/insert.h"
+
+#include <random>
+
+namespace {
+	template<bool bNegate, typename CodeUnitSet, typename Char>
+	void CheckAllVectorWidths(tc::vector<Char> const& vecch) noexcept {
+		auto const pchBegin = vecch.data();
+		auto const pchEnd = pchBegin + vecch.size();
+		for (auto pch = pchBegin; pch != pchEnd; ++pch) {
+			auto const pchExpected = tc::simd::no_adl::find_first_scalar<bNegate, CodeUnitSet>(pch, pchEnd);
+			_ASSERTEQUAL((tc::simd::no_adl::find_first<bNegate, CodeUnitSet>(pch, pchEnd)), pchExpected);
+		#if BOOST_ARCH_X86
+			_ASSERTEQUAL((tc::simd::no_adl::find_first_sse2<bNegate, CodeUnitSet>(pch, pchEnd)), pchExpected);
+			if (tc::simd::esimdlevelAVX2 <= tc::simd::supported_simd_level()) {
+				_ASSERTEQUAL((tc::simd::no_adl::find_first_avx2<bNegate, CodeUnitSet>(pch, pchEnd)), pchExpected);
+			}
+			if (tc::simd::esimdlevelAVX512 <= tc::simd::supported_simd_level()) {
+				_ASSERTEQUAL((tc::simd::no_adl::find_first_avx512<bNegate, CodeUnitSet>(pch, pchEnd)), pchExpected);
+			}
+		#elif BOOST_ARCH_ARM
+			_ASSERTEQUAL((tc::simd::no_adl::find_first_neon<bNegate, CodeUnitSet>(pch, pchEnd)), pchExpected);
+		#endif
+		}
+	}
+
+	template<typename Char>
+	void CheckCodeUnitSets() noexcept {
+		std::mt19937 gen(42);
+		for (int const nMax : {0x7F, 0xFF, int{std::numeric_limits<std::make_unsigned_t<Char>>::max()}}) {
+			tc::vector<Char> vecch;
+			for (int i = 0; i < 300; ++i) {
+				// Mostly letters, so that matches are sparse enough to exercise the vector loops.
+				auto const n = std::uniform_int_distribution<int>(0, 15)(gen);
+				tc::cont_emplace_back(vecch, static_cast<Char>(0 == n ? std::uniform_int_distribution<int>(0, nMax)(gen) : 'a' + n));
+			}
+			CheckAllVectorWidths</*bNegate*/false, tc::simd::code_unit_set<0x20, 0x7F, '"', '\\'>>(vecch);
+			CheckAllVectorWidths</*bNegate*/false, tc::simd::any_of<'<', '&'>>(vecch);
+			CheckAllVectorWidths</*bNegate*/false, tc::simd::code_unit_set<0x10, 0x9F>>(vecch);
+			CheckAllVectorWidths</*bNegate*/true, tc::simd::any_of<'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'>>(vecch);
+		}
+	}
+
+	template<typename... CodeUnitSet>
+	void CheckBlockMasks(char const* const pch) noexcept {
+		auto const anExpected = tc::simd::no_adl::block_masks_scalar<CodeUnitSet...>(pch);
+		_ASSERT(tc::simd::block_masks<CodeUnitSet...>(pch) == anExpected);
+	#if BOOST_ARCH_X86
+		_ASSERT(tc::simd::no_adl::block_masks_sse2<CodeUnitSet...>(pch) == anExpected);
+		if (tc::simd::esimdlevelAVX2 <= tc::simd::supported_simd_level()) {
+			_ASSERT(tc::simd::no_adl::block_masks_avx2<CodeUnitSet...>(pch) == anExpected);
+		}
+		if (tc::simd::esimdlevelAVX512 <= tc::simd::supported_simd_level()) {
+			_ASSERT(tc::simd::no_adl::block_masks_avx512<CodeUnitSet...>(pch) == anExpected);
+		}
+	#elif BOOST_ARCH_ARM
+		_ASSERT(tc::simd::no_adl::block_masks_neon<CodeUnitSet...>(pch) == anExpected);
+	#endif
+	}
+}
+
+UNITTESTDEF(simd_block_masks) {
+	std::mt19937 gen(42);
+	tc::vector<char> vecch;
+	for (int i = 0; i < 64 * 8; ++i) {
+		tc::cont_emplace_back(vecch, static_cast<char>(std::uniform_int_distribution<int>(0, 0xFF)(gen)));
+	}
+	for (auto i = 0; i + 64 <= tc::size(vecch); i += 7) {
+		CheckBlockMasks<tc::simd::any_of<'"'>, tc::simd::code_unit_set<0x20, 0x7F>, tc::simd::any_of<'{', '}', '[', ']', ',', ':'>>(vecch.data() + i);
+	}
+}
+
+UNITTESTDEF(simd_find_first_of) {
+	CheckCodeUnitSets<char>();
+	CheckCodeUnitSets<char16_t>();
+
+	static auto constexpr c_str = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef\"";
+	auto const pchEnd = c_str + std::char_traits<char>::length(c_str);
+	_ASSERTEQUAL((tc::simd::find_first_of<tc::simd::any_of<'"'>>(c_str, pchEnd)), pchEnd - 1);
+	_ASSERTEQUAL((tc::simd::find_first_of<tc::simd::any_of<'x'>>(c_str, pchEnd)), pchEnd);
+	_ASSERTEQUAL((tc::simd::find_first_not_of<tc::simd::code_unit_set<0x7F, 0xFF>>(c_str, pchEnd)), pchEnd);
+}
+
+namespace {
+	void CheckUtf8Validation(tc::vector<char> const& vecch) noexcept {
+		auto const pchBegin = vecch.data();
+		auto const pchEnd = pchBegin + vecch.size();
+		for (auto pch = pchBegin; pch < pchEnd; pch += 5) {
+			auto const pchExpected = tc::simd::no_adl::find_first_invalid_utf8_scalar(pch, pchEnd);
+			_ASSERTEQUAL(tc::simd::find_first_invalid_utf8(pch, pchEnd), pchExpected);
+		#if BOOST_ARCH_X86
+			_ASSERTEQUAL(tc::simd::no_adl::find_first_invalid_utf8_sse2(pch, pchEnd), pchExpected);
+			if (tc::simd::esimdlevelAVX2 <= tc::simd::supported_simd_level()) {
+				_ASSERTEQUAL(tc::simd::no_adl::is_valid_utf8_avx2(pch, pchEnd), pchEnd == pchExpected);
+			}
+		#elif BOOST_ARCH_ARM
+			_ASSERTEQUAL(tc::simd::no_adl::is_valid_utf8_neon(pch, pchEnd), pchEnd == pchExpected);
+		#endif
+		}
+	}
+}
+
+UNITTESTDEF(simd_utf8_validation) {
+	auto const FindFirstInvalid = [](char const* const str) noexcept {
+		auto const pchEnd = str + std::char_traits<char>::length(str);
+		return tc::simd::find_first_invalid_utf8(str, pchEnd) - str;
+	};
+	_ASSERTEQUAL(FindFirstInvalid(""), 0);
+	_ASSERTEQUAL(FindFirstInvalid("abc\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80\xF4\x8F\xBF\xBF\xED\x9F\xBF"), 19);
+	_ASSERTEQUAL(FindFirstInvalid("ab\x80"), 2); // continuation byte without lead byte
+	_ASSERTEQUAL(FindFirstInvalid("ab\xC1\xBF"), 2); // overlong 2 byte sequence
+	_ASSERTEQUAL(FindFirstInvalid("ab\xE0\x9F\xBF"), 2); // overlong 3 byte sequence
+	_ASSERTEQUAL(FindFirstInvalid("ab\xF0\x8F\xBF\xBF"), 2); // overlong 4 byte sequence
+	_ASSERTEQUAL(FindFirstInvalid("ab\xED\xA0\x80"), 2); // surrogate
+	_ASSERTEQUAL(FindFirstInvalid("ab\xF4\x90\x80\x80"), 2); // greater than U+10FFFF
+	_ASSERTEQUAL(FindFirstInvalid("ab\xF5\x80\x80\x80"), 2);
+	_ASSERTEQUAL(FindFirstInvalid("ab\xE2\x82"), 2); // truncated
+	_ASSERTEQUAL(FindFirstInvalid("ab\xE2\x82x"), 2);
+	_ASSERTEQUAL(FindFirstInvalid("ab\xC3\xA4\xA4"), 4); // too long
+
+	// Mostly valid text with sparse errors, at all offsets relative to the vector boundaries.
+	static constexpr char const* c_astrCodePoint[] = {"a", "b", " ", "\xC3\xA4", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xEF\xBF\xBF", "\xF4\x8F\xBF\xBF"};
+	static constexpr char const* c_astrInvalid[] = {"\x80", "\xBF", "\xC0\x80", "\xC3", "\xE2\x82", "\xED\xA0\x80", "\xF0\x9F\x98", "\xF4\x90\x80\x80", "\xF8", "\xFF"};
+	std::mt19937 gen(42);
+	for (int i = 0; i < 100; ++i) {
+		tc::vector<char> vecch;
+		bool const bValid = 0 == i % 4;
+		while (tc::size(vecch) < 200) {
+			auto const str = !bValid && 0 == std::uniform_int_distribution<int>(0, 63)(gen)
+				? c_astrInvalid[std::uniform_int_distribution<std::size_t>(0, std::size(c_astrInvalid) - 1)(gen)]
+				: c_astrCodePoint[std::uniform_int_distribution<std::size_t>(0, std::size(c_astrCodePoint) - 1)(gen)];
+			for (auto pch = str; *pch; ++pch) tc::cont_emplace_back(vecch, *pch);
+		}
+		if (bValid) _ASSERTEQUAL(tc::simd::no_adl::find_first_invalid_utf8_scalar(vecch.data(), vecch.data() + vecch.size()), vecch.data() + vecch.size());
+		CheckUtf8Validation(vecch);
+	}
+}
@@ -0,0 +1,38 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+
+namespace tc::swar_detail {
+	// SWAR (SIMD within a register): 8 ASCII digits loaded into a little endian 64 bit integer, see https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+
+	[[nodiscard]] constexpr bool is_eight_digits(std::uint64_t const n) noexcept {
+		return 0x3333333333333333 == ((n & 0xF0F0F0F0F0F0F0F0) | (((n + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4));
+	}
+
+	[[nodiscard]] constexpr std::uint32_t eight_digits_value(std::uint64_t n) noexcept {
+		n -= 0x3030303030303030;
+		n = n * 10 + (n >> 8); // pairs of digits
+		return static_cast<std::uint32_t>(((n & 0x000000FF000000FF) * 0x000F424000000064 + ((n >> 16) & 0x000000FF000000FF) * 0x0000271000000001) >> 32);
+	}
+
+	template<typename It>
+	constexpr bool c_bSwar = std::endian::little == std::endian::native && std::contiguous_iterator<It> && 1 == sizeof(std::iter_value_t<It>);
+
+	template<typename It>
+	[[nodiscard]] std::uint64_t load_eight_chars(It const it) noexcept {
+		std::uint64_t n;
+		std::memcpy(std::addressof(n), std::to_address(it), sizeof(n));
+		return n;
+	}
+}
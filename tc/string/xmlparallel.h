@@ -0,0 +1,156 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "xmlparser.h"
+#include "simd.h"
+#include "../algorithm/append.h"
+#include "../algorithm/for_each_batch_parallel.h"
+#include "../container/insert.h"
+
+#include <array>
+
+namespace tc::xml {
+	using tc::unordered_tag_t;
+	using tc::unordered_tag;
+
+	namespace for_each_child_parallel_detail {
+		// Large enough to make the synchronization per batch negligible, small enough to balance the load between threads.
+		inline constexpr std::size_t c_nBatchSize = 1 << 18;
+
+		// Returns the position after the first '>' at or after pch + sizeof...(chs) that is preceded by chs..., or nullptr.
+		template<char... chs>
+		char const* skip_over(char const* pch, char const* const pchEnd) noexcept {
+			static constexpr std::array<char, sizeof...(chs) + 1> c_ach{chs..., '>'};
+			if (tc::explicit_cast<std::size_t>(pchEnd - pch) < sizeof...(chs)) return nullptr;
+			pch += sizeof...(chs);
+			for (;;) {
+				pch = tc::simd::find_first_of<tc::simd::any_of<'>'>>(pch, pchEnd);
+				if (pchEnd == pch) return nullptr;
+				++pch;
+				if (tc::equal(tc::make_iterator_range(pch - tc::size(c_ach), pch), c_ach)) return pch;
+			}
+		}
+
+		// Returns the position after the '>' that ends the tag, skipping over quoted attribute values, or nullptr.
+		inline char const* skip_tag(char const* pch, char const* const pchEnd) noexcept {
+			for (;;) {
+				pch = tc::simd::find_first_of<tc::simd::any_of<'"', '\'', '>'>>(pch, pchEnd);
+				if (pchEnd == pch) return nullptr;
+				switch (*pch) {
+				case '>':
+					return pch + 1;
+				case '"':
+					pch = tc::simd::find_first_of<tc::simd::any_of<'"'>>(pch + 1, pchEnd);
+					break;
+				default:
+					pch = tc::simd::find_first_of<tc::simd::any_of<'\''>>(pch + 1, pchEnd);
+					break;
+				}
+				if (pchEnd == pch) return nullptr;
+				++pch;
+			}
+		}
+
+		// Finds the content of the root element and cuts it into batches at the beginnings of its children. Returns the beginning of the content, the beginnings of
+		// the batches after the first one, and the end of the content. Only markup delimiters are looked at, skipping comments, CDATA sections, processing
+		// instructions and quoted attribute values, which is much faster than parsing. Returns an empty vector if the document cannot be split,
+		// e.g., because it is malformed, in which case it is parsed as a whole to report errors.
+		inline tc::vector<char const*> split_content(char const* pch, char const* const pchEnd) noexcept {
+			tc::vector<char const*> vecpch;
+			std::size_t nDepth = 0;
+			for (;;) {
+				pch = tc::simd::find_first_of<tc::simd::any_of<'<'>>(pch, pchEnd);
+				if (pchEnd == pch) return {};
+				auto const pchMarkup = pch;
+				auto const strMarkup = tc::make_iterator_range(pch, pchEnd);
+				if (tc::starts_with<tc::return_bool>(strMarkup, "<!--")) {
+					pch = skip_over<'-', '-'>(pch + 4, pchEnd);
+				} else if (tc::starts_with<tc::return_bool>(strMarkup, "<![CDATA[")) {
+					pch = skip_over<']', ']'>(pch + 9, pchEnd);
+				} else if (tc::starts_with<tc::return_bool>(strMarkup, "<?")) {
+					pch = skip_over<'?'>(pch + 2, pchEnd);
+				} else if (tc::starts_with<tc::return_bool>(strMarkup, "<!")) {
+					return {}; // DOCTYPE etc. are not supported by tc::xml::parser
+				} else if (tc::starts_with<tc::return_bool>(strMarkup, "</")) {
+					pch = skip_over<>(pch + 2, pchEnd);
+					if (!pch || 0 == nDepth) return {};
+					if (0 == --nDepth) {
+						tc::cont_emplace_back(vecpch, pchMarkup);
+						return vecpch;
+					}
+				} else {
+					pch = skip_tag(pch + 1, pchEnd);
+					if (!pch) return {};
+					bool const bEmptyElement = '/' == pch[-2];
+					if (0 == nDepth) {
+						if (bEmptyElement) return {}; // nothing to split
+						tc::cont_emplace_back(vecpch, pch);
+					} else if (1 == nDepth && c_nBatchSize <= tc::explicit_cast<std::size_t>(pchMarkup - tc::back(vecpch))) {
+						tc::cont_emplace_back(vecpch, pchMarkup);
+					}
+					if (!bEmptyElement) ++nDepth;
+				}
+				if (!pch) return {};
+			}
+		}
+	}
+
+	// Parses a document whose root element contains many records, e.g., <records><record .../><record .../>...</records>, on all cores.
+	// The content of the root element is cut into batches between children, and every batch is parsed by its own tc::xml::parser
+	// from a copy of the document that only contains the children of the batch. The root element, and thus the namespace declarations in it, is the same in all copies.
+	// func is called for every child of the root element, with the parser on the opening tag of the child, and must consume the child up to and including its end.
+	// Namespaces must be registered with the parser that is passed to func, and the results of func must not refer to the input of that parser.
+	// func and the copies of errorhandler are called concurrently. The input and the positions that errorhandler receives refer to the copy of the document
+	// that is parsed, not to rng, unless the document is not split into batches.
+	// The results of func are passed to sink on the calling thread, in input order, or with unordered_tag in the order in which the batches are done.
+	// An exception thrown by func or errorhandler stops the parsing and is rethrown on the calling thread.
+	template<typename Rng, typename ErrorHandler, typename Func, typename Sink, typename... Tag>
+	auto for_each_child_parallel(Rng const& rng, ErrorHandler const& errorhandler, Func const& func, Sink&& sink, Tag... tag) MAYTHROW {
+		static_assert(tc::contiguous_range<Rng const&> && std::is_same<char, tc::range_value_t<Rng const&>>::value);
+		using namespace for_each_child_parallel_detail;
+
+		auto const pchBegin = tc::ptr_begin(rng);
+		auto const pchEnd = pchBegin + tc::size(rng);
+		using document_t = decltype(tc::make_iterator_range(pchBegin, pchEnd));
+		using result_t = decltype(func(std::declval<tc::xml::parser<document_t, ErrorHandler>&>()));
+		static_assert(!std::is_void<result_t>::value);
+
+		auto const Parse = [&](char const* const pchDocument, char const* const pchDocumentEnd) MAYTHROW {
+			tc::vector<result_t> vecresult;
+			auto parser = tc::xml::make_parser(tc::make_iterator_range(pchDocument, pchDocumentEnd), errorhandler); // MAYTHROW
+			VERIFY(parser.child()); // the root element, see parser::parser
+			while (parser.child()) { // MAYTHROW
+				tc::cont_emplace_back(vecresult, func(parser)); // MAYTHROW
+			}
+			parser.expect_element_end(); // MAYTHROW
+			parser.expect_end(); // MAYTHROW
+			return vecresult;
+		};
+
+		auto const vecpch = split_content(pchBegin, pchEnd);
+		if (tc::size(vecpch) <= 2) {
+			return tc::for_each_batch_parallel(1, [&](tc::unused) MAYTHROW {
+				return Parse(pchBegin, pchEnd); // MAYTHROW
+			}, tc_move_if_owned(sink), tag...); // MAYTHROW
+		} else {
+			return tc::for_each_batch_parallel(tc::size(vecpch) - 1, [&](std::size_t const iBatch) MAYTHROW {
+				tc::string<char> strDocument;
+				tc::append(
+					strDocument,
+					tc::make_iterator_range(pchBegin, tc::front(vecpch)),
+					tc::make_iterator_range(vecpch[iBatch], vecpch[iBatch + 1]),
+					tc::make_iterator_range(tc::back(vecpch), pchEnd)
+				); // MAYTHROW
+				auto const pchDocument = tc::ptr_begin(strDocument);
+				return Parse(pchDocument, pchDocument + tc::size(strDocument)); // MAYTHROW
+			}, tc_move_if_owned(sink), tag...); // MAYTHROW
+		}
+	}
+}
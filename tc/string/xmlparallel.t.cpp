@@ -0,0 +1,72 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "xmlparallel.h"
+#include "../algorithm/append.h"
+#include "../algorithm/algorithm.h"
+#include "../range/iota_range.h"
+#include "format.h"
+
+namespace {
+	struct ExFailure final {};
+
+	auto const c_errorhandler = tc::xml::simple_error_handler([](tc::unused) THROW(ExFailure) {
+		throw ExFailure();
+	});
+
+	int ParseRecord(auto& parser) MAYTHROW {
+		auto const nsP = parser.register_namespace("urn:p");
+		auto const n = parser.expect_parse_attribute(tc::xml::integer<int>, "i");
+		parser.expect_child(nsP, "text");
+		_ASSERT(tc::equal(parser.characters(), "</record>"));
+		parser.expect_element_end();
+		parser.expect_element_end();
+		return n;
+	}
+}
+
+UNITTESTDEF(XMLForEachChildParallel) {
+	// Spans several batches, with markup delimiters in comments, CDATA sections and attribute values.
+	tc::string<char> str = R"(<?xml version="1.0"?><!-- <a> --><records xmlns:p="urn:p">)";
+	int const nRecords = 20000;
+	for (int i = 0; i < nRecords; ++i) {
+		tc::append(str, "\n\t<record i=\"", tc::as_dec(i), "\" s='/>&quot;&apos;'><p:text><![CDATA[</record>]]></p:text><!-- </record> --></record>");
+	}
+	tc::append(str, "\n</records>\n");
+
+	{
+		tc::vector<int> vecn;
+		tc::xml::for_each_child_parallel(str, c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [&](int const n) noexcept {
+			tc::cont_emplace_back(vecn, n);
+		});
+		_ASSERT(tc::equal(vecn, tc::iota(0, nRecords)));
+	}
+	{
+		tc::vector<int> vecn;
+		tc::xml::for_each_child_parallel(str, c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [&](int const n) noexcept {
+			tc::cont_emplace_back(vecn, n);
+		}, tc::xml::unordered_tag);
+		tc::sort_inplace(vecn);
+		_ASSERT(tc::equal(vecn, tc::iota(0, nRecords)));
+	}
+	{
+		// Malformed documents are parsed as a whole, and the error is reported.
+		for (auto const& strInvalid : {tc::make_str(tc::concat(str, "<records/>")), tc::make_str(tc::take(str, tc::begin(str) + tc::size(str) / 2))}) {
+			try {
+				tc::xml::for_each_child_parallel(strInvalid, c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [](int) noexcept {}); // THROW(ExFailure)
+				_ASSERTFALSE;
+			} catch (ExFailure const&) {}
+		}
+	}
+	{
+		int nSunk = 0;
+		tc::xml::for_each_child_parallel(tc::make_str("<records/>"), c_errorhandler, [](auto& parser) MAYTHROW { return ParseRecord(parser); }, [&](int) noexcept { ++nSunk; });
+		_ASSERTEQUAL(nSunk, 0);
+	}
+}
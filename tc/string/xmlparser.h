@@ -12,7 +12,12 @@
 #include "spirit.h"
 #include "../container/container.h"
 #include "../container/cont_assign.h"
+#include "../algorithm/algorithm.h"
+#include "../range/iota_range.h"
 #include "../range/join_framed_adaptor.h"
+#include "../base/string_template_param.h"
+
+#include <array>
 
 namespace tc::xml {
 	namespace no_adl {
@@ -84,6 +89,9 @@ namespace tc::xml {
 			void unsupported_declaration_found(auto const& strInput, tc::unused /*itch*/) const& MAYTHROW {
 				m_func(strInput);
 			}
+			void invalid_encoding(auto const& strInput, tc::unused /*itch*/) const& MAYTHROW {
+				m_func(strInput);
+			}
 
 		private:
 			Func m_func;
@@ -234,6 +242,28 @@ namespace tc::xml {
 				tc::constant<tc::continue_>
 			> {
 				auto& base=this->base_range();
+				if constexpr(sizeof(char_type)<=2 && tc::contiguous_range<Rng const&> && tc::common_range<Rng const&>) {
+					// Runs without entities are passed to the sink as a whole, which an appender inserts at once.
+					// Adjacent entities are decoded into a buffer, which is passed to the sink as a whole, too.
+					char_type const* pch=tc::ptr_begin(base);
+					char_type const* const pchEnd=pch+tc::size(base);
+					for(;;) {
+						auto const pchEntity=tc::simd::find_first_of<tc::simd::any_of<'&'>>(pch, pchEnd);
+						if(pch!=pchEntity) tc_return_if_break( tc::for_each(tc::make_iterator_range(pch, pchEntity), sink) );
+						if(pchEnd==pchEntity) return tc::constant<tc::continue_>();
+
+						auto const rngEntities=decode_adaptor<decltype(tc::make_iterator_range(pchEntity, pchEnd))>(tc::aggregate_tag, tc::make_iterator_range(pchEntity, pchEnd));
+						pch=pchEntity;
+						char_type ach[16];
+						std::size_t nch=0;
+						do {
+							ach[nch]=rngEntities.template ProcessEscaped<true>(pch); // MAYTHROW
+							++nch;
+						} while(nch<tc::size(ach) && pchEnd!=pch && tc::char_ascii('&')==*pch);
+						char_type const* const pchBuffer=ach;
+						tc_return_if_break( tc::for_each(tc::make_iterator_range(pchBuffer, pchBuffer+nch), sink) );
+					}
+				}
 				auto idx=tc::begin_index(base);
 				for(;;) {
 					if(tc::at_end_index(base, idx)) return tc::constant<tc::continue_>();
@@ -280,13 +310,17 @@ namespace tc::xml {
 		);
 	}
 
+	// Passed to make_parser, defers splitting the attributes of a tag into names and values until they are accessed. Until then, the parser only
+	// scans for the end of the tag, so malformed attributes are only reported when attribute() or attributes() is called on the tag.
+	DEFINE_TAG_TYPE(lazy_attributes_tag)
+
 	namespace no_adl {
 		template< typename T, typename = void >
 		struct has_discard_until : std::false_type { };
 
-		// specialization recognizes types that do have a nested ::type member:
+		// specialization recognizes types that do have a member function discard_until:
 		template< typename T >
-		struct has_discard_until<T, std::void_t<decltype(&std::declval<T>().discard_until)> > : std::true_type {};
+		struct has_discard_until<T, std::void_t<decltype(&std::remove_reference_t<T>::discard_until)> > : std::true_type {};
 
 #pragma push_macro("case_whitespace")
 #define case_whitespace case tc::explicit_cast<char_type>('\t'): case tc::explicit_cast<char_type>('\n'): case tc::explicit_cast<char_type>('\r'): case tc::explicit_cast<char_type>(' ')
@@ -322,7 +356,20 @@ namespace tc::xml {
 			}
 		};
 
-		template<typename String, typename ErrorHandler>
+		// FNV-1a over the code units of any range, so that maps keyed by tc::string can be searched with subranges of the input without copying them.
+		struct hash_chars final {
+			using is_transparent = void;
+
+			std::size_t operator()(auto const& str) const& noexcept {
+				std::uint64_t n = 0xcbf29ce484222325ull;
+				tc::for_each(str, [&](auto const ch) noexcept {
+					n = (n ^ static_cast<std::make_unsigned_t<tc::decay_t<decltype(ch)>>>(ch)) * 0x100000001b3ull;
+				});
+				return static_cast<std::size_t>(n);
+			}
+		};
+
+		template<typename String, typename ErrorHandler, bool c_bLazyAttributes = false>
 		struct [[nodiscard]] parser : parser_base<String, ErrorHandler>, namespace_info<tc::range_value_t<String>> {
 		private:
 			using base_ = parser_base<String, ErrorHandler>;
@@ -337,6 +384,8 @@ namespace tc::xml {
 				, m_strMain(tc::slice(this->input(), this->m_itchInput, this->m_itchInput))
 				, m_bConsumed(false)
 			{
+				// The xml prefix is bound by definition and need not be declared: https://www.w3.org/TR/2006/REC-xml-names11-20060816/#xmlReserved
+				tc::cont_must_emplace(m_mapstrns, tc::make_str<char_type>(tc_ascii("xml")), this->register_namespace(tc::make_str<char_type>(tc_ascii("http://www.w3.org/XML/1998/namespace"))));
 				Next(); // MAYTHROW
 				SkipWhitespaceCharacters(); // MAYTHROW
 				switch_no_default(m_exmlentity) {
@@ -348,7 +397,11 @@ namespace tc::xml {
 				}
 			}
 
-			using base_::expect_end;
+			// Whitespace may follow the root element: https://www.w3.org/TR/2006/REC-xml11-20060816/#NT-document
+			void expect_end() & MAYTHROW {
+				this->skip_whitespace_maybe_end();
+				base_::expect_end(); // MAYTHROW
+			}
 
 			[[nodiscard]] auto characters() & MAYTHROW {
 				EnsureFresh(); // MAYTHROW
@@ -514,8 +567,10 @@ namespace tc::xml {
 				expect_skip_child(/*ons*/ nullptr, strName); // MAYTHROW
 			}
 
+			// The descendants are only scanned for the ends of their tags, i.e., their attributes and namespace declarations are not tokenized,
+			// and character data is not validated.
 			void skip_rest_of_element() & MAYTHROW {
-				EnsureFresh(); // MAYTHROW
+				EnsureFresh</*bSkipping*/true>(); // MAYTHROW
 				m_bConsumed=true;
 				if(exmlentityEMPTYELEMENTCLOSING!=m_exmlentity) {
 					int nOpenElements=1;
@@ -530,7 +585,7 @@ namespace tc::xml {
 							break;
 						default: ;
 						}
-						Next(); // MAYTHROW
+						Next</*bSkipping*/true>(); // MAYTHROW
 					}
 				}
 			}
@@ -574,29 +629,64 @@ namespace tc::xml {
 				}
 			}
 
-			[[nodiscard]] auto attribute(auto const& strName) & noexcept {
-				// TODO: Attributes can have qualified names **but** the default namespace never applies to unqualified attributes:
-				// An attribute with unqualified name always has no namespace value, not the default namespace.
-				// See https://www.w3.org/TR/2006/REC-xml-names11-20060816/#scoping-defaulting
+			[[nodiscard]] auto attribute(auto const& strName) & noexcept(!c_bLazyAttributes) {
 				_ASSERTANYOF(m_exmlentity, (exmlentityEMPTYELEMENT)(exmlentityOPENINGTAG));
-				return tc::and_then(
-					tc::find_first_if<tc::return_element_or_null>(m_vecpairstrAttributes, [&](auto const& pairstrstr) noexcept {
-						return tc::equal(pairstrstr.first, strName);
-					}),
-					[&](auto const& pairstrstr) noexcept {
-						return std::optional(xml::decode(pairstrstr.second));
+				EnsureAttributesTokenized(); // MAYTHROW if c_bLazyAttributes
+				return DecodedAttribute([&]() noexcept -> std::optional<std::size_t> {
+					if(tc::size(m_vecpairstrAttributes)<=c_nAttributesLinearSearch) {
+						return tc::find_first_if<tc::return_element_index_or_none>(m_vecpairstrAttributes, [&](auto const& pairstrstr) noexcept {
+							return tc::equal(pairstrstr.first, strName);
+						});
+					} else {
+						if(tc::empty(m_vecnAttributeByName)) {
+							tc::cont_assign(m_vecnAttributeByName, tc::iota(tc::explicit_cast<std::size_t>(0), tc::size(m_vecpairstrAttributes)));
+							tc::sort_inplace(m_vecnAttributeByName, [&](std::size_t const nLhs, std::size_t const nRhs) noexcept {
+								auto const order = tc::lexicographical_compare_3way(m_vecpairstrAttributes[nLhs].first, m_vecpairstrAttributes[nRhs].first);
+								return std::is_lt(order) || (std::is_eq(order) && nLhs<nRhs); // the first of duplicate attributes is found, as by a linear search
+							});
+						}
+						auto const Name = [&](auto const& nOrStr) noexcept -> decltype(auto) {
+							if constexpr (std::same_as<std::size_t, tc::decay_t<decltype(nOrStr)>>) {
+								return (m_vecpairstrAttributes[nOrStr].first);
+							} else {
+								return (nOrStr);
+							}
+						};
+						return tc::binary_find_first<tc::return_value_or_none>(m_vecnAttributeByName, strName, [&](auto const& lhs, auto const& rhs) noexcept {
+							return tc::lexicographical_compare_3way(Name(lhs), Name(rhs));
+						});
 					}
-				);
+				}());
 			}
 
-			[[nodiscard]] auto attributes() const& noexcept {
-				return tc::transform(
-					m_vecpairstrAttributes,
-					[&](auto const& pairstrstr) noexcept {
-						// FIXME: Support attribute without value
-						return std::make_pair(pairstrstr.first, xml::decode(pairstrstr.second));
+			// Attributes without prefix have no namespace, not the default namespace:
+			// https://www.w3.org/TR/2006/REC-xml-names11-20060816/#scoping-defaulting
+			[[nodiscard]] auto attribute(Namespace ons, auto const& strName) & MAYTHROW {
+				_ASSERTANYOF(m_exmlentity, (exmlentityEMPTYELEMENT)(exmlentityOPENINGTAG));
+				EnsureAttributesTokenized(); // MAYTHROW
+				if(tc::size(m_vecnsAttributes)!=tc::size(m_vecpairstrAttributes)) {
+					tc::cont_assign(m_vecnsAttributes);
+					for(auto const& pairstrstr : m_vecpairstrAttributes) {
+						tc::cont_emplace_back(m_vecnsAttributes, [&]() MAYTHROW -> Namespace {
+							auto const strPrefix = split_qualified_name(pairstrstr.first).first;
+							if(tc::empty(strPrefix)) return nullptr;
+							if(auto const ons = namespace_for_prefix(strPrefix)) return ons;
+							this->template error_at<tc_mem_fn(.invalid_namespace_prefix)>(m_itchEntityBegin); // MAYTHROW
+						}());
 					}
-				);
+				}
+				return DecodedAttribute(tc::find_first_if<tc::return_value_or_none>(tc::iota(tc::explicit_cast<std::size_t>(0), tc::size(m_vecpairstrAttributes)), [&](std::size_t const n) noexcept {
+					return ons==m_vecnsAttributes[n] && tc::equal(split_qualified_name(m_vecpairstrAttributes[n].first).second, strName);
+				}));
+			}
+
+			[[nodiscard]] auto attributes() const& noexcept requires (!c_bLazyAttributes) {
+				return DecodedAttributes();
+			}
+
+			[[nodiscard]] auto attributes() & MAYTHROW requires c_bLazyAttributes {
+				EnsureAttributesTokenized(); // MAYTHROW
+				return tc::as_const(*this).DecodedAttributes();
 			}
 
 			[[nodiscard]] auto expect_attribute(auto& strName) & MAYTHROW {
@@ -632,14 +722,8 @@ namespace tc::xml {
 
 			template<typename Str>
 			Namespace /* may be nullptr */ namespace_for_prefix(Str const& strNsPrefix) const& noexcept {
-				if(auto const opairstrns = tc::find_last_if<tc::return_element_or_null>(
-					m_stkpairstrns,
-					[&](auto const& pairstrns) noexcept {
-						return c_nsStackSeparator!=pairstrns.second
-							&& tc::equal(pairstrns.first, strNsPrefix);
-					}
-				)) {
-					return opairstrns->second;
+				if(auto const itpairstrns = tc::cont_find<tc::return_element_or_null>(m_mapstrns, strNsPrefix)) {
+					return itpairstrns->second;
 				} else {
 					return nullptr;
 				}
@@ -650,17 +734,25 @@ namespace tc::xml {
 			EXmlEntity m_exmlentity=exmlentitySTART;
 			bool m_bConsumed;
 				
-#ifdef _MSC_VER
-			static constexpr Namespace c_nsStackSeparator = std::addressof(tc_as_constexpr(tc::string<char_type>{}));
-#else
-			static tc::string<char_type> const c_strDummy;
-			static Namespace const c_nsStackSeparator;
-#endif
-			tc::vector<std::pair<tc::string< char_type >, Namespace>> m_stkpairstrns; // must not store sub_range in case input string is discarded
+			// The namespace that each prefix is bound to in the current scope, nullptr if none. The default namespace has the empty prefix.
+			// Keys are never erased, so that m_stknsdecl can refer to them. Keys must not be sub_ranges in case the input string is discarded.
+			tc::unordered_map_range<tc::string<char_type>, Namespace, no_adl::hash_chars> m_mapstrns;
+			struct SNamespaceDeclaration final {
+				std::size_t m_nDepth; // the element that declares the namespace
+				std::pair<tc::string<char_type> const, Namespace>* m_ppairstrns;
+				Namespace m_nsShadowed; // the binding that is restored at the end of the element
+			};
+			tc::vector<SNamespaceDeclaration> m_stknsdecl; // the declarations in scope, in document order
+			std::size_t m_nDepth=0; // the number of open elements, including an empty element
 
 		private:
 			tc::iterator_t<String const> m_itchEntityBegin;
+			tc::iterator_t<String const> m_itchAttributes; // the first attribute of the current tag, if not yet tokenized
+			bool m_bAttributesTokenized=true;
 			tc::vector<std::pair<tc::make_subrange_result_t< String const& >, tc::make_subrange_result_t< String const& >>> m_vecpairstrAttributes;
+			static constexpr std::size_t c_nAttributesLinearSearch = 8;
+			tc::vector<std::size_t> m_vecnAttributeByName; // indices into m_vecpairstrAttributes, sorted by name, built on first lookup
+			tc::vector<Namespace> m_vecnsAttributes; // the namespaces of m_vecpairstrAttributes, resolved on first lookup by namespace
 			
 			void WithCharacters(auto func) & MAYTHROW {
 				IF_TC_CHECKS(bool bOnce = false;)
@@ -675,52 +767,255 @@ namespace tc::xml {
 				);
 			}
 
-			void SkipUntil(char_type const ch) & MAYTHROW {
-				for(;;) {
+			using base_::c_bVectorizableFind;
+			// Character data and attribute values in 1 byte encodings are validated as UTF-8 if the error handler can report invalid_encoding.
+			// Error handlers written before invalid_encoding existed keep accepting any code units.
+			static constexpr bool c_bValidateEncoding = 1==sizeof(char_type) && requires(ErrorHandler const& errorhandler, std::remove_reference_t<String> const& strInput, tc::iterator_t<String const> itch) {
+				errorhandler.invalid_encoding(strInput, itch);
+			};
+
+			// Advances to the next occurrence of one of chs. It is an error if there is none.
+			template<char... chs>
+			void SkipUntil() & MAYTHROW {
+				if constexpr (c_bVectorizableFind) {
+					auto const pch = std::to_address(this->m_itchInput);
+					this->m_itchInput += tc::simd::find_first_of<tc::simd::any_of<chs...>>(pch, std::to_address(this->m_end)) - pch;
+				} else {
+					while (this->m_itchInput != this->m_end && ((tc::explicit_cast<char_type>(chs) != *this->m_itchInput) && ...)) {
+						++this->m_itchInput;
+					}
+				}
+				this->expect_not_end(); // MAYTHROW
+			}
+
+			// Advances to the closing quotation mark of an attribute value.
+			template<char chQuote>
+			void SkipAttributeValue() & MAYTHROW {
+				if constexpr (c_bValidateEncoding) {
+					this->template skip_utf8_until<tc::simd::any_of<chQuote>>(); // MAYTHROW
 					this->expect_not_end(); // MAYTHROW
-					if(ch==*this->m_itchInput) break;
-					++this->m_itchInput;
+				} else {
+					SkipUntil<chQuote>(); // MAYTHROW
 				}
 			}
 
 			void SkipOverGreaterThan() & MAYTHROW {
-				SkipUntil(tc::char_ascii('>')); // MAYTHROW
+				SkipUntil<'>'>(); // MAYTHROW
 				++this->m_itchInput;
 			}
 
-			void SkipOver(char_type const ch1, char_type const ch2) & MAYTHROW {
-				bool bHave1=false;
+			// Advances past the next occurrence of ch1 followed by ch2.
+			template<char ch1, char ch2>
+			void SkipOver() & MAYTHROW {
 				this->expect_not_end(); // MAYTHROW
-				for(;;) {
-					bHave1 = ch1==*this->m_itchInput;
-					++this->m_itchInput;
-					this->expect_not_end(); // MAYTHROW
-					if(ch2==*this->m_itchInput && bHave1) break;
+				if constexpr (c_bVectorizableFind) {
+					for (;;) {
+						++this->m_itchInput;
+						SkipUntil<ch2>(); // MAYTHROW
+						if (tc::explicit_cast<char_type>(ch1) == this->m_itchInput[-1]) break;
+					}
+				} else {
+					for(;;) {
+						bool const bHave1 = tc::explicit_cast<char_type>(ch1)==*this->m_itchInput;
+						++this->m_itchInput;
+						this->expect_not_end(); // MAYTHROW
+						if(tc::explicit_cast<char_type>(ch2)==*this->m_itchInput && bHave1) break;
+					}
 				}
 				++this->m_itchInput;
 			}
 
-			void Next() & MAYTHROW {
-			restart:
-				if constexpr (has_discard_until<decltype((*this->m_strInput))>::value) {
-					this->m_strInput->discard_until(tc::iterator2index<String>(this->m_itchInput));
+			// With c_bLazyAttributes, finds the end of the tag, skipping over attribute values, but does not tokenize the attributes until they are accessed.
+			// Namespace declarations are in scope for the name of the tag, so a tag that may contain them is tokenized right away, unless the element is skipped.
+			template<bool bSkipping>
+			void SkipAttributes() & MAYTHROW {
+				for(;;) {
+					this->skip_whitespace();
+					switch(*this->m_itchInput) {
+					case tc::explicit_cast<char_type>('>'):
+						++this->m_itchInput;
+						m_exmlentity=exmlentityOPENINGTAG;
+						return;
+					case tc::explicit_cast<char_type>('/'):
+						++this->m_itchInput;
+						this->expect_literal(">"_tc);
+						m_exmlentity=exmlentityEMPTYELEMENT;
+						return;
+					default: ;
+					}
+
+					if(bSkipping || !AtNamespaceDeclaration()) { // MAYTHROW
+						SkipUntil<'"', '\'', '>', '/'>(); // MAYTHROW
+						switch(*this->m_itchInput) {
+						case tc::explicit_cast<char_type>('"'):
+							++this->m_itchInput;
+							SkipUntil<'"'>(); // MAYTHROW
+							++this->m_itchInput;
+							continue;
+						case tc::explicit_cast<char_type>('\''):
+							++this->m_itchInput;
+							SkipUntil<'\''>(); // MAYTHROW
+							++this->m_itchInput;
+							continue;
+						default: ; // the attribute has no value, tokenizing reports the error
+						}
+					}
+					TokenizeAttributes(); // MAYTHROW
 				}
+			}
 
-				this->expect_not_end(); // MAYTHROW
-				m_itchEntityBegin=this->m_itchInput;
+			bool AtNamespaceDeclaration() const& MAYTHROW {
+				auto itch=this->m_itchInput;
+				for(char const ch : {'x', 'm', 'l', 'n', 's'}) {
+					if(itch==this->m_end || tc::explicit_cast<char_type>(ch)!=*itch) return false;
+					++itch;
+				}
+				return true;
+			}
+
+			void EnsureAttributesTokenized() & noexcept(!c_bLazyAttributes) {
+				if constexpr (c_bLazyAttributes) {
+					if(!m_bAttributesTokenized) {
+						auto const itchEndOfTag=this->m_itchInput;
+						TokenizeAttributes(); // MAYTHROW
+						this->m_itchInput=itchEndOfTag;
+					}
+				} else {
+					_ASSERT(m_bAttributesTokenized);
+				}
+			}
+
+			// Parses the attributes from m_itchAttributes up to the end of the tag.
+			void TokenizeAttributes() & MAYTHROW {
+				_ASSERT(!m_bAttributesTokenized);
+				m_bAttributesTokenized=true;
+				this->m_itchInput=m_itchAttributes;
+				for(;;) {
+					this->skip_whitespace();
+					switch(*this->m_itchInput) {
+					case tc::explicit_cast<char_type>('>'):
+					case tc::explicit_cast<char_type>('/'):
+						return;
+					default: ;
+					}
+
+					auto strAttribute=[&]() MAYTHROW {
+						auto itchBegin = this->m_itchInput;
+						for(;;) {
+							switch(auto const ch = *this->m_itchInput) {
+							case tc::explicit_cast<char_type>('='):
+								{
+									auto strAttribute=tc::slice(this->input(), itchBegin, this->m_itchInput);
+									if (tc::empty(strAttribute)) {
+										this->template error<tc_mem_fn(.attribute_name_expected)>(); // MAYTHROW
+									}
+									++this->m_itchInput;
+									return strAttribute;
+								}
+							case_whitespace:
+								{
+									auto strAttribute=tc::slice(this->input(), itchBegin, this->m_itchInput);
+									++this->m_itchInput;
+									this->skip_whitespace();
+									this->expect_literal("="_tc);
+									return strAttribute;
+								}
+							default:
+								++this->m_itchInput;
+								this->expect_not_end(); // MAYTHROW
+							}
+						}
+					}();
+					this->skip_whitespace();
+
+					switch(auto const ch=*this->m_itchInput) {
+					default:
+						this->template error<tc_mem_fn(.quotation_marks_expected)>(); // MAYTHROW
+					case tc::explicit_cast<char_type>('"'): case tc::explicit_cast<char_type>('\''):
+						++this->m_itchInput;
+						auto const itchBegin=this->m_itchInput;
+						if (tc::explicit_cast<char_type>('"') == ch) {
+							SkipAttributeValue<'"'>(); // MAYTHROW
+						} else {
+							SkipAttributeValue<'\''>(); // MAYTHROW
+						}
+
+						auto strValue = tc::slice(this->input(), itchBegin, this->m_itchInput);
+						if(auto ostrPrefix = [&]() MAYTHROW -> std::optional<tc::make_subrange_result_t<String const&>> {
+							if(auto ostr = tc::starts_with<tc::return_drop_or_none>(strAttribute, tc_ascii("xmlns"))) {
+								if(tc::starts_with<tc::return_bool>(*ostr, tc_ascii(":"))) {
+									tc::drop_first_inplace(*ostr);
+									if(tc::empty(*ostr)) {
+										this->template error_at<tc_mem_fn(.parse_error)>(m_itchEntityBegin, m_strMain, strAttribute); // MAYTHROW
+									}
+									return ostr;
+								} else if(tc::empty(*ostr)) {
+									return ostr;
+								}
+							}
+							return std::nullopt;
+						}()) {
+							DeclareNamespace(*ostrPrefix, tc::empty(strValue) ? nullptr : this->register_namespace(strValue));
+						} else {
+							tc::cont_emplace_back(m_vecpairstrAttributes, tc_move(strAttribute), strValue);
+						}
+						++this->m_itchInput;
+					}
+				}
+			}
+
+			auto DecodedAttribute(std::optional<std::size_t> const on) const& noexcept {
+				return tc::and_then(on, [&](std::size_t const n) noexcept {
+					return std::optional(xml::decode(m_vecpairstrAttributes[n].second));
+				});
+			}
+
+			auto DecodedAttributes() const& noexcept {
+				return tc::transform(
+					m_vecpairstrAttributes,
+					[&](auto const& pairstrstr) noexcept {
+						// FIXME: Support attribute without value
+						return std::make_pair(pairstrstr.first, xml::decode(pairstrstr.second));
+					}
+				);
+			}
+
+			void DeclareNamespace(auto const& strPrefix, Namespace const ns) & noexcept {
+				auto& pairstrns = *tc::cont_try_emplace(m_mapstrns, tc::make_str(strPrefix), nullptr).first;
+				tc::cont_emplace_back(m_stknsdecl, SNamespaceDeclaration{m_nDepth, std::addressof(pairstrns), pairstrns.second});
+				pairstrns.second = ns;
+			}
+
+			// Only elements that declare namespaces have entries in m_stknsdecl, so leaving any other element is cheap.
+			void EndNamespaceScope() & noexcept {
+				_ASSERT(0<m_nDepth);
+				while(!tc::empty(m_stknsdecl) && m_nDepth==tc::back(m_stknsdecl).m_nDepth) {
+					tc::back(m_stknsdecl).m_ppairstrns->second = tc::back(m_stknsdecl).m_nsShadowed;
+					tc::drop_last_inplace(m_stknsdecl);
+				}
+				--m_nDepth;
+			}
+
+			// While skipping an element, its descendants are only scanned for the ends of their tags.
+			template<bool bSkipping = false>
+			void Next() & MAYTHROW {
 				switch(m_exmlentity) {
 				case exmlentityCLOSINGTAG:
 				case exmlentityEMPTYELEMENTCLOSING:
-					tc::take_inplace(
-						m_stkpairstrns,
-						tc::find_last_if<tc::return_element>(m_stkpairstrns, [&](auto const& pairstrns) noexcept {
-							return c_nsStackSeparator==pairstrns.second;
-						})
-					);
+				case exmlentityEMPTYELEMENT: // skipped without EnsureFresh
+					EndNamespaceScope();
 					break;
 				default: ;
 				};
 
+			restart: // after comments and processing instructions, which must not pop the namespace stack again
+				if constexpr (has_discard_until<decltype((*this->m_strInput))>::value) {
+					this->m_strInput->discard_until(tc::iterator2index<String>(this->m_itchInput));
+				}
+
+				this->expect_not_end(); // MAYTHROW
+				m_itchEntityBegin=this->m_itchInput;
+
 				if(tc::char_ascii('<')==*this->m_itchInput) {
 					++this->m_itchInput;
 					this->expect_not_end(); // MAYTHROW
@@ -729,7 +1024,7 @@ namespace tc::xml {
 						this->template error<tc_mem_fn(.name_expected)>(); // MAYTHROW
 					case tc::explicit_cast<char_type>('?'): // processing instruction or prolog
 						++this->m_itchInput;
-						SkipOver(tc::char_ascii('?'), tc::char_ascii('>'));
+						SkipOver<'?', '>'>();
 						goto restart;
 					case tc::explicit_cast<char_type>('/'): // closing tag
 					{
@@ -747,7 +1042,7 @@ namespace tc::xml {
 						case tc::explicit_cast<char_type>('-'): // comment
 							++this->m_itchInput;
 							this->expect_literal("-"_tc);
-							SkipOver(tc::char_ascii('-'), tc::char_ascii('-'));
+							SkipOver<'-', '-'>();
 							this->expect_literal(">"_tc);
 							goto restart;
 						case tc::explicit_cast<char_type>('['): // CDATA
@@ -758,14 +1053,8 @@ namespace tc::xml {
 								auto const itchBegin=this->m_itchInput;
 								int nClosing;
 								decltype(this->m_itchInput) aitchEnd[2];
-								goto start;
-
 								for(;;) {
-									do {
-										++this->m_itchInput;
-									start:
-										this->expect_not_end(); // MAYTHROW
-									} while(tc::char_ascii(']')!=*this->m_itchInput);
+									SkipUntil<']'>(); // MAYTHROW
 
 									nClosing=0;
 									do {
@@ -787,7 +1076,10 @@ namespace tc::xml {
 						}
 					default: // opening tag or empty element
 						tc::cont_assign(m_vecpairstrAttributes);
-						tc::cont_emplace_back(m_stkpairstrns, tc::take(this->input(), tc::begin(this->input())), c_nsStackSeparator);
+						tc::cont_assign(m_vecnAttributeByName);
+						tc::cont_assign(m_vecnsAttributes);
+						m_bAttributesTokenized=true;
+						++m_nDepth;
 
 						auto itchBegin=this->m_itchInput;
 						++this->m_itchInput;
@@ -811,90 +1103,24 @@ namespace tc::xml {
 							case_whitespace:
 								m_strMain=tc::slice(this->input(), itchBegin, this->m_itchInput);
 								++this->m_itchInput;
-								for(;;) {
-									this->skip_whitespace();
-									switch(*this->m_itchInput) {
-									case tc::explicit_cast<char_type>('>'):
-										++this->m_itchInput;
-										m_exmlentity=exmlentityOPENINGTAG;
-										return;
-									case tc::explicit_cast<char_type>('/'):
-										++this->m_itchInput;
-										this->expect_literal(">"_tc);
-										m_exmlentity=exmlentityEMPTYELEMENT;
-										return;
-									default: ;
-									}
-
-									auto strAttribute=[&]() MAYTHROW {
-										auto itchBegin = this->m_itchInput;
-										for(;;) {
-											switch(auto const ch = *this->m_itchInput) {
-											case tc::explicit_cast<char_type>('='):
-												{
-													auto strAttribute=tc::slice(this->input(), itchBegin, this->m_itchInput);
-													if (tc::empty(strAttribute)) {
-														this->template error<tc_mem_fn(.attribute_name_expected)>(); // MAYTHROW
-													}
-													++this->m_itchInput;
-													return strAttribute;
-												}
-											case_whitespace:
-												{
-													auto strAttribute=tc::slice(this->input(), itchBegin, this->m_itchInput);
-													++this->m_itchInput;
-													this->skip_whitespace();
-													this->expect_literal("="_tc);
-													return strAttribute;
-												}
-											default:
-												++this->m_itchInput;
-												this->expect_not_end(); // MAYTHROW
-											}
-										}
-									}();
-									this->skip_whitespace();
-
-									switch(auto const ch=*this->m_itchInput) {
-									default:
-										this->template error<tc_mem_fn(.quotation_marks_expected)>(); // MAYTHROW
-									case tc::explicit_cast<char_type>('"'): case tc::explicit_cast<char_type>('\''):
-										++this->m_itchInput;
-										itchBegin=this->m_itchInput;
-										SkipUntil(ch);
-
-										auto strValue = tc::slice(this->input(), itchBegin, this->m_itchInput);
-										if(auto ostrPrefix = [&]() MAYTHROW -> std::optional<tc::make_subrange_result_t<String const&>> {
-											if(auto ostr = tc::starts_with<tc::return_drop_or_none>(strAttribute, tc_ascii("xmlns"))) {
-												if(tc::starts_with<tc::return_bool>(*ostr, tc_ascii(":"))) {
-													tc::drop_first_inplace(*ostr);
-													if(tc::empty(*ostr)) {
-														this->template error_at<tc_mem_fn(.parse_error)>(m_itchEntityBegin, m_strMain, strAttribute); // MAYTHROW
-													}
-													return ostr;
-												} else if(tc::empty(*ostr)) {
-													return ostr;
-												}
-											}
-											return std::nullopt;
-										}()) {
-											tc::cont_emplace_back(
-												m_stkpairstrns,
-												tc_move_always(*ostrPrefix),
-												tc::empty(strValue) ? nullptr : this->register_namespace(strValue)
-											);
-										} else {
-											tc::cont_emplace_back(m_vecpairstrAttributes, tc_move(strAttribute), strValue);
-										}
-										++this->m_itchInput;
-									}
+								m_itchAttributes=this->m_itchInput;
+								m_bAttributesTokenized=false;
+								if constexpr (!c_bLazyAttributes && !bSkipping) {
+									TokenizeAttributes(); // MAYTHROW, stops at the end of the tag
 								}
+								SkipAttributes<bSkipping>(); // MAYTHROW
+								return;
 							}
 						}
 					}
 				} else {
-					++this->m_itchInput;
-					SkipUntil(tc::char_ascii('<'));
+					if constexpr (c_bValidateEncoding && !bSkipping) {
+						this->template skip_utf8_until<tc::simd::any_of<'<'>>(); // MAYTHROW
+						this->expect_not_end(); // MAYTHROW
+					} else {
+						++this->m_itchInput;
+						SkipUntil<'<'>(); // MAYTHROW
+					}
 					m_strMain=tc::slice(this->input(), m_itchEntityBegin, this->m_itchInput);
 					m_exmlentity=exmlentityCHARACTERS;
 				}
@@ -908,26 +1134,35 @@ namespace tc::xml {
 					case exmlentityCDATA:
 						this->template error_at<tc_mem_fn(.unsupported_declaration_found)>(m_itchEntityBegin); // MAYTHROW
 					case exmlentityCHARACTERS:
-						tc_auto_cref(itEnd, tc::end(m_strMain));
-						for (auto it = tc::begin(m_strMain); itEnd != it; ++it) {
-							switch(*it) {
-							default:
-								this->template error_at<tc_mem_fn(.characters_unexpected)>(it); // MAYTHROW
-							case_whitespace:
-								;
+						if constexpr (c_bVectorizableFind) {
+							auto const pchBegin = std::to_address(tc::begin(m_strMain));
+							auto const pchEnd = std::to_address(tc::end(m_strMain));
+							if (auto const pch = tc::simd::find_first_not_of<typename base_::whitespace>(pchBegin, pchEnd); pchEnd != pch) {
+								this->template error_at<tc_mem_fn(.characters_unexpected)>(tc::begin(m_strMain) + (pch - pchBegin)); // MAYTHROW
 							}
-						};
+						} else {
+							tc_auto_cref(itEnd, tc::end(m_strMain));
+							for (auto it = tc::begin(m_strMain); itEnd != it; ++it) {
+								switch(*it) {
+								default:
+									this->template error_at<tc_mem_fn(.characters_unexpected)>(it); // MAYTHROW
+								case_whitespace:
+									;
+								}
+							};
+						}
 						Next(); // MAYTHROW
 					}
 				}
 			}
 
+			template<bool bSkipping = false>
 			void EnsureFresh() & MAYTHROW {
 				if(m_bConsumed) {
 					if(exmlentityEMPTYELEMENT==m_exmlentity) {
 						m_exmlentity=exmlentityEMPTYELEMENTCLOSING;
 					} else {
-						Next();
+						Next<bSkipping>();
 					}
 				}
 
@@ -939,11 +1174,6 @@ namespace tc::xml {
 			}
 		};
 #pragma pop_macro("case_whitespace")
-
-#ifndef _MSC_VER
-		template<typename String, typename ErrorHandler> tc::string<typename parser<String, ErrorHandler>::char_type> const parser<String, ErrorHandler>::c_strDummy{};
-		template<typename String, typename ErrorHandler> typename parser<String, ErrorHandler>::Namespace const parser<String, ErrorHandler>::c_nsStackSeparator = std::addressof(c_strDummy);
-#endif
 	}
 	using no_adl::simple_error_handler;
 	using no_adl::namespace_info;
@@ -957,6 +1187,11 @@ namespace tc::xml {
 	[[nodiscard]] auto make_parser(String&& str, ErrorHandler&& errorhandler, Args&&... args) MAYTHROW {
 		return no_adl::parser<String, tc::decay_t<ErrorHandler>>(tc_move_if_owned(str), tc_move_if_owned(errorhandler), tc_move_if_owned(args)...); // MAYTHROW
 	}
+
+	template<typename String, typename ErrorHandler>
+	[[nodiscard]] auto make_parser(String&& str, ErrorHandler&& errorhandler, tc::xml::lazy_attributes_tag_t) MAYTHROW {
+		return no_adl::parser<String, tc::decay_t<ErrorHandler>, /*c_bLazyAttributes*/true>(tc_move_if_owned(str), tc_move_if_owned(errorhandler)); // MAYTHROW
+	}
 	
 	void for_each_descendant( auto& parser, auto funcOpen, auto funcClose) MAYTHROW {
 		int nOpenElements = 1;
@@ -974,6 +1209,62 @@ namespace tc::xml {
 		}
 	}
 
+	namespace for_each_descendant_detail {
+		template<tc::string_template_param strPath>
+		constexpr std::size_t c_nSteps = []() noexcept {
+			std::size_t n = 1;
+			for (auto const ch : strPath) {
+				if (tc::explicit_cast<decltype(ch)>('/') == ch) ++n;
+			}
+			return n;
+		}();
+
+		// The beginnings of the steps in strPath, followed by the end of strPath plus one, i.e., step n is [c_aidxStep[n], c_aidxStep[n+1]-1).
+		template<tc::string_template_param strPath>
+		constexpr auto c_aidxStep = []() noexcept {
+			std::array<std::size_t, c_nSteps<strPath> + 1> aidx{};
+			std::size_t n = 0;
+			for (std::size_t idx = 0; idx < strPath.size(); ++idx) {
+				if (tc::explicit_cast<tc::decay_t<decltype(strPath[idx])>>('/') == strPath[idx]) aidx[++n] = idx + 1;
+			}
+			aidx[c_nSteps<strPath>] = strPath.size() + 1;
+			return aidx;
+		}();
+
+		// Visits the children of the current element that match step nStep, and skips all others, leaving the parser at the end of the current element.
+		template<tc::string_template_param strPath, std::size_t nStep>
+		void for_each_match(auto& parser, auto& func) MAYTHROW {
+			constexpr std::size_t idxBegin = c_aidxStep<strPath>[nStep];
+			constexpr std::size_t idxEnd = c_aidxStep<strPath>[nStep + 1] - 1;
+			static_assert(idxBegin < idxEnd, "Path steps must not be empty.");
+			constexpr bool c_bAnyName = idxBegin + 1 == idxEnd && tc::explicit_cast<tc::decay_t<decltype(strPath[idxBegin])>>('*') == strPath[idxBegin];
+
+			while (parser.child()) { // MAYTHROW
+				if (c_bAnyName || tc::equal(parser.qualified_tag_name(), tc::make_iterator_range(strPath.begin() + idxBegin, strPath.begin() + idxEnd))) {
+					if constexpr (nStep + 1 == c_nSteps<strPath>) {
+						func(); // MAYTHROW
+						parser.skip_rest_of_element(); // MAYTHROW
+					} else {
+						for_each_match<strPath, nStep + 1>(parser, func); // MAYTHROW
+						parser.expect_element_end(); // MAYTHROW
+					}
+				} else {
+					parser.skip_rest_of_element(); // MAYTHROW
+				}
+			}
+		}
+	}
+
+	// Calls func for every descendant of the current element whose path relative to the current element matches strPath, e.g., "b/*/c".
+	// Steps are separated by '/' and are either a qualified element name or '*' for any element. The path is split at compile time,
+	// and every subtree that cannot match is skipped by skip_rest_of_element as soon as its root does not match, which only scans it for the ends of tags.
+	// func is called with the parser on the opening tag of a matching element, and may consume attributes and children, but not the end of the element.
+	// The rest of the matching element is skipped when func returns. Like for_each_descendant, leaves the parser at the end of the current element.
+	template<tc::string_template_param strPath>
+	void for_each_descendant(auto& parser, auto func) MAYTHROW {
+		for_each_descendant_detail::for_each_match<strPath, 0>(parser, func); // MAYTHROW
+	}
+
 	namespace no_adl {
 		inline struct {
 			[[nodiscard]] std::optional<bool> operator()(auto const& str) const& noexcept {
@@ -12,10 +12,26 @@
 
 #include "xmlparser.h"
 #include "xmltransform.h"
+#include "../range/repeat_n.h"
 
 using SAssertingErrorHandler = tc::xml::simple_error_handler<decltype([](tc::unused) noexcept { _ASSERTFALSE; })>;
 struct ExErrorHandled final {};
 
+UNITTESTDEF(xml_decode) {
+	auto const Test = [](auto const& str, auto const& strExpected) noexcept {
+		auto const rng = tc::xml::decode(str);
+		_ASSERT(tc::equal(tc::make_str(rng), strExpected)); // runs and entities are passed to the sink as a whole
+		_ASSERT(tc::equal(tc::make_str(tc::make_iterator_range(tc::begin(rng), tc::end(rng))), strExpected)); // character by character
+	};
+	Test(tc::make_str(""), "");
+	Test(tc::make_str("text"), "text");
+	Test(tc::make_str("a &amp; b"), "a & b");
+	Test(tc::make_str("&lt;&gt;&amp;&quot;&apos;&#65;&#x42;"), "<>&\"'AB");
+	Test(tc::make_str("&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;text&gt;"), "<<<<<<<<<<<<<<<<<<<<text>"); // more than fit into the buffer
+	Test(tc::make_str("&&amp;;&unknown;&amp"), "&;&&");
+	Test(tc::make_str(u"&#x3b1;&lt;&#x3b2;"), u"α<β");
+}
+
 UNITTESTDEF(xmlparser_error_handling) {
 	{
 		struct SErrorHandler final : SAssertingErrorHandler {
@@ -82,12 +98,249 @@ UNITTESTDEF(xmlparser_error_handling) {
 		} catch (ExErrorHandled const&) {
 		}
 	}
+	{
+		struct SErrorHandler final : SAssertingErrorHandler {
+			void invalid_encoding(tc::span<char const> strInput, char const* itch) const& THROW(ExErrorHandled) {
+				_ASSERT(tc::equal(tc::drop(strInput, itch), "\xE2\x82</a>"));
+				throw ExErrorHandled();
+			}
+		};
+		try {
+			auto parser = tc::xml::make_parser("<a>\xC3\xA4 &amp; \xE2\x82\xAC\xE2\x82</a>", SErrorHandler());
+			_ASSERT(parser.child("a"));
+			tc::discard(parser.characters());
+			_ASSERTFALSE;
+		} catch (ExErrorHandled const&) {
+		}
+	}
+	{
+		struct SErrorHandler final : SAssertingErrorHandler {
+			void invalid_encoding(tc::span<char const> strInput, char const* itch) const& THROW(ExErrorHandled) {
+				_ASSERT(tc::equal(tc::drop(strInput, itch), "\xC3'/>"));
+				throw ExErrorHandled();
+			}
+		};
+		try {
+			auto parser = tc::xml::make_parser("<a x=\"\xC3\xA4\" y='\xC3'/>", SErrorHandler());
+			_ASSERTFALSE;
+		} catch (ExErrorHandled const&) {
+		}
+	}
+	{
+		// Error handlers without invalid_encoding do not validate the encoding.
+		struct SErrorHandler final : private SAssertingErrorHandler {
+			using SAssertingErrorHandler::semantic_error;
+			using SAssertingErrorHandler::parse_warning;
+			using SAssertingErrorHandler::parse_error;
+			using SAssertingErrorHandler::end_unexpected;
+			using SAssertingErrorHandler::end_expected;
+			using SAssertingErrorHandler::root_expected;
+			using SAssertingErrorHandler::name_expected;
+			using SAssertingErrorHandler::invalid_namespace_prefix;
+			using SAssertingErrorHandler::attribute_name_expected;
+			using SAssertingErrorHandler::child_expected;
+			using SAssertingErrorHandler::char_expected;
+			using SAssertingErrorHandler::characters_expected;
+			using SAssertingErrorHandler::characters_unexpected;
+			using SAssertingErrorHandler::attribute_expected;
+			using SAssertingErrorHandler::element_end_expected;
+			using SAssertingErrorHandler::quotation_marks_expected;
+			using SAssertingErrorHandler::unsupported_declaration_found;
+		};
+		auto parser = tc::xml::make_parser("<a x='\xC3'>\xE2\x82</a>", SErrorHandler());
+		parser.expect_child("a");
+		_ASSERT(tc::equal(*parser.attribute("x"), "\xC3"));
+		_ASSERT(tc::equal(parser.characters(), "\xE2\x82"));
+		parser.expect_element_end();
+		parser.expect_end();
+	}
 }
 
 namespace {
 	constexpr char c_strMsoNamespace[] = {"http://schemas.microsoft.com/office/2009/07/customui"};
 }
 
+UNITTESTDEF(xmlparser_whitespace) {
+	auto const strIndent = tc::make_str(tc::concat("\n", tc::repeat_n(40, ' ')));
+	{
+		auto const strXml = tc::make_str(tc::concat("<a", strIndent, "b=\"1\"", strIndent, ">", strIndent, "<c/>", strIndent, "</a>", strIndent));
+		auto parser = tc::xml::make_parser(strXml, SAssertingErrorHandler());
+		parser.expect_child("a");
+		_ASSERT(tc::equal(parser.expect_attribute("b"), "1"));
+		parser.expect_child("c");
+		parser.expect_element_end();
+		parser.expect_element_end();
+	}
+	{
+		struct SErrorHandler final : SAssertingErrorHandler {
+			void characters_unexpected(tc::unused, char const* itch) const& THROW(ExErrorHandled) {
+				_ASSERTEQUAL(*itch, 'x');
+				throw ExErrorHandled();
+			}
+		};
+		auto const strXml = tc::make_str(tc::concat("<a>", strIndent, "x", strIndent, "<c/></a>"));
+		auto parser = tc::xml::make_parser(tc::span<char const>(strXml), SErrorHandler());
+		parser.expect_child("a");
+		try {
+			parser.expect_child("c");
+			_ASSERTFALSE;
+		} catch (ExErrorHandled const&) {
+		}
+	}
+}
+
+UNITTESTDEF(xmlparser_delimiters) {
+	// Long enough for vectorized scanning, with delimiters close to the boundaries of vectors.
+	auto const strText = tc::make_str(tc::repeat_n(100, 'x'));
+	auto const Test = [&]<typename Char>(tc::type::identity<Char>) noexcept {
+		auto const Str = [](auto const&... rng) noexcept { return tc::make_str<Char>(tc::concat(rng...)); };
+		auto const strXml = Str(
+			"<?xml version=\"1.0\"?><!--", strText, "-->",
+			"<a b='", strText, "\"' c=\"", strText, "'\">",
+				strText, "&amp;<?pi ?", strText, "?>",
+				"<![CDATA[", strText, "]]]]>",
+				"<d/><!---", strText, "- -->",
+				"<![CDATA[]]>",
+			"</a>"
+		);
+		auto parser = tc::xml::make_parser(strXml, SAssertingErrorHandler());
+		parser.expect_child(Str("a"));
+		auto const strB = Str("b");
+		_ASSERT(tc::equal(parser.expect_attribute(strB), Str(strText, "\"")));
+		auto const strC = Str("c");
+		_ASSERT(tc::equal(parser.expect_attribute(strC), Str(strText, "'")));
+		_ASSERT(tc::equal(tc::make_str<Char>(parser.characters()), Str(strText, "&")));
+		_ASSERT(tc::equal(tc::make_str<Char>(parser.characters()), Str(strText, "]]")));
+		parser.expect_child(Str("d"));
+		parser.expect_element_end();
+		_ASSERT(tc::empty(tc::make_str<Char>(parser.characters())));
+		parser.expect_element_end();
+		parser.expect_end();
+	};
+	Test(tc::type::identity<char>());
+	Test(tc::type::identity<char16_t>());
+
+	struct SErrorHandler final : SAssertingErrorHandler {
+		void end_unexpected(tc::unused, tc::unused) const& THROW(ExErrorHandled) {
+			throw ExErrorHandled();
+		}
+	};
+	for (auto const strXml : {
+		tc::make_str(tc::concat("<a>", strText)),
+		tc::make_str(tc::concat("<a>", strText, "<!--", strText, "->")),
+		tc::make_str(tc::concat("<a>", strText, "<![CDATA[", strText, "]>")),
+		tc::make_str(tc::concat("<a b='", strText, "\">")),
+	}) {
+		try {
+			auto parser = tc::xml::make_parser(strXml, SErrorHandler());
+			parser.expect_child("a");
+			parser.skip_rest_of_element();
+			_ASSERTFALSE;
+		} catch (ExErrorHandled const&) {
+		}
+	}
+}
+
+UNITTESTDEF(xmlparser_attributes) {
+	auto const Check = [](auto... tag) noexcept {
+		{
+			// More attributes than are searched linearly
+			auto parser = tc::xml::make_parser(R"(<a a0="0" a1="1" a2='2' a3="3" a4="4" a5="5" a6="6" a7="&lt;7&gt;" a8="8" a9="9" a1="duplicate"/>)", SAssertingErrorHandler(), tag...);
+			parser.expect_child("a");
+			_ASSERT(tc::equal(*parser.attribute("a9"), "9"));
+			_ASSERT(tc::equal(*parser.attribute("a0"), "0"));
+			_ASSERT(tc::equal(*parser.attribute("a1"), "1"));
+			_ASSERT(tc::equal(*parser.attribute("a7"), "<7>"));
+			_ASSERT(!parser.attribute("a"));
+			_ASSERT(!parser.attribute("a10"));
+			_ASSERTEQUAL(tc::size(parser.attributes()), 11);
+			static_assert(noexcept(parser.attributes()) == (0 == sizeof...(tag)));
+			static_assert(noexcept(parser.attribute("a")) == (0 == sizeof...(tag)));
+			parser.expect_end();
+		}
+		{
+			auto parser = tc::xml::make_parser(R"(<a xmlns="urn:default" xmlns:p="urn:p" x="1" p:x="2"><b p:x="/>"/><c x='>'/></a>)", SAssertingErrorHandler(), tag...);
+			auto const nsDefault = parser.register_namespace("urn:default");
+			auto const nsP = parser.register_namespace("urn:p");
+			parser.expect_child(nsDefault, "a");
+			_ASSERT(tc::equal(*parser.attribute(nsP, "x"), "2"));
+			_ASSERT(tc::equal(*parser.attribute(nullptr, "x"), "1")); // the default namespace does not apply to attributes
+			_ASSERT(!parser.attribute(nsDefault, "x"));
+			_ASSERT(tc::equal(*parser.attribute("p:x"), "2"));
+			parser.expect_child(nsDefault, "b");
+			_ASSERT(tc::equal(*parser.attribute(nsP, "x"), "/>"));
+			parser.expect_element_end();
+			parser.expect_child(nsDefault, "c");
+			_ASSERT(tc::equal(*parser.attribute("x"), ">"));
+			parser.expect_element_end();
+			parser.expect_element_end();
+			parser.expect_end();
+		}
+		{
+			// Attribute prefixes are resolved on the first lookup by namespace, so an undeclared prefix is only reported then.
+			struct SErrorHandler final : SAssertingErrorHandler {
+				void invalid_namespace_prefix(tc::unused, tc::unused) const& THROW(ExErrorHandled) {
+					throw ExErrorHandled();
+				}
+			};
+			auto parser = tc::xml::make_parser(R"(<a q:x="1"/>)", SErrorHandler(), tag...);
+			parser.expect_child("a");
+			_ASSERT(tc::equal(*parser.attribute("q:x"), "1"));
+			try {
+				void(parser.attribute(nullptr, "x"));
+				_ASSERTFALSE;
+			} catch (ExErrorHandled const&) {
+			}
+		}
+		{
+			struct SErrorHandler final : SAssertingErrorHandler {
+				void quotation_marks_expected(tc::unused, tc::unused) const& THROW(ExErrorHandled) {
+					throw ExErrorHandled();
+				}
+			};
+			auto parser = tc::xml::make_parser(R"(<a><b x="1" y=2/></a>)", SErrorHandler(), tag...);
+			parser.expect_child("a");
+			try {
+				parser.skip_rest_of_element();
+				_ASSERTFALSE;
+			} catch (ExErrorHandled const&) {
+			}
+		}
+	};
+	Check();
+	Check(tc::xml::lazy_attributes_tag);
+
+	{
+		struct SErrorHandler final : SAssertingErrorHandler {
+			void attribute_name_expected(tc::unused, tc::unused) const& THROW(ExErrorHandled) {
+				throw ExErrorHandled();
+			}
+		};
+		static constexpr char c_sz[] = R"(<a><b x="1" ="2"/></a>)";
+		{
+			// By default, attributes are validated when the tag is parsed.
+			auto parser = tc::xml::make_parser(c_sz, SErrorHandler());
+			parser.expect_child("a");
+			try {
+				parser.expect_child("b");
+				_ASSERTFALSE;
+			} catch (ExErrorHandled const&) {
+			}
+		}
+		{
+			// Lazy attributes are only validated when they are accessed.
+			auto parser = tc::xml::make_parser(c_sz, SErrorHandler(), tc::xml::lazy_attributes_tag);
+			parser.expect_child("a");
+			parser.expect_child("b");
+			try {
+				void(parser.attribute("x"));
+				_ASSERTFALSE;
+			} catch (ExErrorHandled const&) {
+			}
+		}
+	}
+}
+
 UNITTESTDEF(namespace_) {
 	static constexpr char asz[] = R"(
 <mso:customUI xmlns:mso="http://schemas.microsoft.com/office/2009/07/customui">
@@ -202,6 +455,103 @@ UNITTESTDEF(default_namespace_override) {
 	NOEXCEPT(parser.expect_child("tabs"));
 }
 
+UNITTESTDEF(namespace_scope) {
+	static constexpr char asz[] = R"(
+<a xmlns:p="urn:1">
+	<p:b xmlns:p="urn:2" xmlns:q="urn:2">
+		<p:c xmlns:p="urn:3"/>
+		<p:c/>
+	</p:b><p:skipped xmlns:p="urn:2"/><p:skipped xmlns:p="urn:2"><p:d xmlns:p="urn:3"/></p:skipped>
+	<p:d/>
+</a>
+)";
+
+	auto parser=tc::xml::make_parser(asz, SAssertingErrorHandler());
+	auto const ns1 = parser.register_namespace("urn:1");
+	auto const ns2 = parser.register_namespace("urn:2");
+	auto const ns3 = parser.register_namespace("urn:3");
+
+	NOEXCEPT(parser.expect_child("a"));
+	NOEXCEPT(parser.expect_child(ns2, "b"));
+	_ASSERTEQUAL(parser.namespace_for_prefix("q"), ns2);
+	_ASSERTEQUAL(parser.namespace_for_prefix(tc::begin_next<tc::return_take>("qp", 1)), ns2); // heterogeneous lookup
+	_ASSERT(!parser.namespace_for_prefix(tc::begin_next<tc::return_take>("qp", 0)));
+	NOEXCEPT(parser.expect_child(ns3, "c"));
+	NOEXCEPT(parser.expect_element_end());
+	NOEXCEPT(parser.expect_child(ns2, "c"));
+	NOEXCEPT(parser.expect_element_end());
+	NOEXCEPT(parser.expect_element_end());
+	// Skipping elements without entering them must leave their scope, too.
+	NOEXCEPT(parser.skip_child_or_characters());
+	_ASSERT(!parser.namespace_for_prefix("q"));
+	NOEXCEPT(parser.skip_child_or_characters());
+	NOEXCEPT(parser.expect_child(ns1, "d"));
+	NOEXCEPT(parser.expect_element_end());
+	NOEXCEPT(parser.expect_element_end());
+}
+
+UNITTESTDEF(namespace_xml_prefix) {
+	static constexpr char asz[] = R"(<a xml:lang="en" b="1"><xml:c xml:space="preserve"/></a>)";
+	auto const Check = [&](auto... tag) noexcept {
+		auto parser=tc::xml::make_parser(asz, SAssertingErrorHandler(), tag...);
+		auto const nsXml = parser.register_namespace("http://www.w3.org/XML/1998/namespace");
+		_ASSERTEQUAL(parser.namespace_for_prefix("xml"), nsXml);
+		NOEXCEPT(parser.expect_child("a"));
+		_ASSERT(tc::equal(*parser.attribute(nullptr, "b"), "1"));
+		_ASSERT(tc::equal(*parser.attribute(nsXml, "lang"), "en"));
+		_ASSERT(!parser.attribute(nullptr, "lang"));
+		NOEXCEPT(parser.expect_child(nsXml, "c"));
+		_ASSERT(tc::equal(*parser.attribute(nsXml, "space"), "preserve"));
+		NOEXCEPT(parser.expect_element_end());
+		NOEXCEPT(parser.expect_element_end());
+	};
+	Check();
+	Check(tc::xml::lazy_attributes_tag);
+}
+
+UNITTESTDEF(for_each_descendant_path) {
+	static constexpr char asz[] = R"(
+<a>
+	<b>
+		<x><c id="1"/><c id="2"><c id="nested"/></c><d><c id="3"/></d></x>
+		<y><c id="4">text</c></y>
+		<c id="5"/>
+	</b>
+	<e><x><c id="6"/></x></e>
+	<b><z/><z><c id="7"/><!-- <c id="8"/> --></z></b>
+</a>
+)";
+	auto parser=tc::xml::make_parser(asz, SAssertingErrorHandler());
+	parser.expect_child("a");
+	tc::vector<int> vecn;
+	tc::xml::for_each_descendant<"b/*/c">(parser, [&]() MAYTHROW {
+		tc::cont_emplace_back(vecn, parser.expect_parse_attribute(tc::xml::integer<int>, "id"));
+	});
+	_ASSERT(tc::equal(vecn, tc::make_array(tc::aggregate_tag, 1, 2, 4, 7)));
+	parser.expect_element_end();
+	parser.expect_end();
+
+	auto parser2=tc::xml::make_parser(asz, SAssertingErrorHandler());
+	parser2.expect_child("a");
+	int n = 0;
+	tc::xml::for_each_descendant<"*">(parser2, [&]() noexcept { ++n; });
+	_ASSERTEQUAL(n, 3);
+	parser2.expect_element_end();
+	parser2.expect_end();
+
+	// The descendants of skipped elements are not tokenized, so their errors go unnoticed.
+	static constexpr char aszSkipped[] = "<a><b><x><y =\"1\" z=\"\xFF\">\xFF<p:y xmlns:p=\"\"/></y></x><c id=\"9\"/></b></a>";
+	auto parser3=tc::xml::make_parser(aszSkipped, SAssertingErrorHandler());
+	parser3.expect_child("a");
+	tc::cont_assign(vecn);
+	tc::xml::for_each_descendant<"b/c">(parser3, [&]() MAYTHROW {
+		tc::cont_emplace_back(vecn, parser3.expect_parse_attribute(tc::xml::integer<int>, "id"));
+	});
+	_ASSERT(tc::equal(vecn, tc::make_array(tc::aggregate_tag, 9)));
+	parser3.expect_element_end();
+	parser3.expect_end();
+}
+
 UNITTESTDEF(xml_transform_append) {
 	static constexpr char asz[] = R"(
 <customUI xmlns:mso="">
@@ -248,26 +248,19 @@ namespace tc::xml {
 			
 			tc::string<char_type> prefix_for_namespace(Namespace ons) const& noexcept {
 				if(ons) {
-					if(auto const opairstrns = tc::find_last_if<tc::return_element_or_null>(
-						this->m_stkpairstrns,
-						[&](auto const& pairstrns) noexcept {
-							return ons==pairstrns.second;
+					if(auto const onsdecl = tc::find_last_if<tc::return_element_or_null>(
+						this->m_stknsdecl,
+						[&](auto const& nsdecl) noexcept {
+							return ons==nsdecl.m_ppairstrns->second; // not shadowed by a later declaration of the same prefix
 						}
 					)) {
-						return opairstrns->first;
+						return onsdecl->m_ppairstrns->first;
 					} else {
 						_ASSERTFALSE; // FIXME: Throw?
 						return tc::string<char_type>();
 					}
 				} else {
-					if(auto const opairstrns = tc::find_last_if<tc::return_element_or_null>(
-						this->m_stkpairstrns,
-						[&](auto const& pairstrns) noexcept {
-							return tc::empty(pairstrns.first)
-								&& pairstrns.second
-								&& this->c_nsStackSeparator!=pairstrns.second;
-						}
-					)) {
+					if(this->namespace_for_prefix(tc::string<char_type>())) {
 						// Default namespace has been redefined
 						_ASSERTFALSE; // FIXME: Throw? 
 						return tc::string<char_type>();
@@ -0,0 +1,282 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "xmlparser.h"
+#include "simd.h"
+#include "format.h"
+#include "../algorithm/append.h"
+#include "../algorithm/quantifier.h"
+#include "../container/insert.h"
+
+namespace tc::xml {
+	namespace no_adl {
+		// The inverse of decode_adaptor: escapes '&', '<' and '>', and in attribute values also '"' and the whitespace that attribute-value normalization
+		// would replace by ' ': https://www.w3.org/TR/2006/REC-xml11-20060816/#AVNormalize
+		// Runs of characters that need no escaping are passed to the sink as a whole, which an appender inserts at once.
+		template<typename Rng, bool bAttribute>
+		struct [[nodiscard]] encode_adaptor : tc::range_adaptor_base_range<Rng> {
+			using char_type = tc::range_value_t<Rng const&>;
+			friend auto range_output_t_impl(encode_adaptor const&) -> tc::type::list<char_type>; // declaration only
+
+			using tc::range_adaptor_base_range<Rng>::range_adaptor_base_range;
+
+		private:
+			static constexpr bool c_bVectorizable = sizeof(char_type) <= 2 && tc::contiguous_range<Rng const&> && tc::common_range<Rng const&>;
+			using code_unit_set_t = std::conditional_t<bAttribute,
+				tc::simd::any_of<'&', '<', '>', '"', '\t', '\n', '\r'>,
+				tc::simd::any_of<'&', '<', '>'>
+			>;
+
+		public:
+			template<typename Sink>
+			auto operator()(Sink sink) const& MAYTHROW {
+				using return_t = tc::common_type_t<
+					decltype(tc::continue_if_not_break(sink, std::declval<char_type>())),
+					decltype(escape(std::declval<char_type>(), sink)),
+					tc::constant<tc::continue_>
+				>;
+				auto const& rng = this->base_range();
+				if constexpr (c_bVectorizable) {
+					auto pch = tc::ptr_begin(rng);
+					auto const pchEnd = pch + tc::size(rng);
+					for (;;) {
+						auto const pchEscape = tc::simd::find_first_of<code_unit_set_t>(pch, pchEnd);
+						if (pch != pchEscape) tc_return_if_break(return_t(tc::for_each(tc::make_iterator_range(pch, pchEscape), sink))); // MAYTHROW
+						if (pchEnd == pchEscape) return return_t(tc::constant<tc::continue_>());
+						tc_return_if_break(return_t(escape(*pchEscape, sink))); // MAYTHROW
+						pch = pchEscape + 1;
+					}
+				} else {
+					return return_t(tc::for_each(rng, [&](char_type const ch) MAYTHROW -> return_t {
+						if (code_unit_set_t::contains(ch)) {
+							return escape(ch, sink); // MAYTHROW
+						} else {
+							return tc::continue_if_not_break(sink, ch); // MAYTHROW
+						}
+					}));
+				}
+			}
+
+			// Counts the characters to escape with the same vectorized search, so that appending the encoded range reserves once.
+			constexpr auto size() const& noexcept requires c_bVectorizable {
+				auto const& rng = this->base_range();
+				auto pch = tc::ptr_begin(rng);
+				auto const pchEnd = pch + tc::size(rng);
+				std::size_t n = tc::size(rng);
+				for (;;) {
+					pch = tc::simd::find_first_of<code_unit_set_t>(pch, pchEnd);
+					if (pchEnd == pch) return n;
+					n += std::char_traits<char>::length(escaped(*pch)) - 1;
+					++pch;
+				}
+			}
+
+		private:
+			static constexpr char const* escaped(char_type const ch) noexcept {
+				switch (ch) {
+				case '&': return "&amp;";
+				case '<': return "&lt;";
+				case '>': return "&gt;";
+				case '"': return "&quot;";
+				case '\t': return "&#9;";
+				case '\n': return "&#10;";
+				case '\r': return "&#13;";
+				default: _ASSERTFALSE; return "";
+				}
+			}
+
+			template<typename Sink>
+			static auto escape(char_type const ch, Sink& sink) MAYTHROW {
+				_ASSERTDEBUG(code_unit_set_t::contains(ch));
+				char_type ach[6];
+				std::size_t n = 0;
+				for (auto pch = escaped(ch); *pch; ++pch, ++n) {
+					ach[n] = tc::explicit_cast<char_type>(*pch);
+				}
+				char_type const* const pchBegin = ach;
+				return tc::for_each(tc::make_iterator_range(pchBegin, pchBegin + n), sink); // MAYTHROW
+			}
+		};
+	}
+
+	template<typename Rng>
+	constexpr auto encode_characters(Rng&& rng)
+		return_ctor_noexcept( TC_FWD(no_adl::encode_adaptor<Rng, /*bAttribute*/false>), (aggregate_tag, tc_move_if_owned(rng)) )
+
+	template<typename Rng>
+	constexpr auto encode_attribute(Rng&& rng)
+		return_ctor_noexcept( TC_FWD(no_adl::encode_adaptor<Rng, /*bAttribute*/true>), (aggregate_tag, tc_move_if_owned(rng)) )
+
+	namespace no_adl {
+		// Writes XML into an appender, e.g., tc::xml::writer writer(tc::appender(str)). No whitespace is written.
+		// Every call writes one piece of markup with a known size, so that the appender reserves once for it.
+		// Elements in a registered namespace are written with its prefix, and the namespace is declared on the element as needed,
+		// i.e., if it is not in scope yet or its prefix has been bound to another namespace. If the prefix is already used by another
+		// namespace on the same start tag, an attribute is written with a generated prefix instead, e.g., a1 for a.
+		template<typename Appender>
+		struct [[nodiscard]] writer final {
+			using Namespace = std::size_t;
+
+			explicit writer(Appender appender) noexcept
+				: m_appender(tc_move(appender))
+			{}
+
+			// An empty prefix stands for the default namespace, which does not apply to attributes.
+			Namespace register_namespace(auto const& strPrefix, auto const& strURI) & noexcept {
+				_ASSERT(!tc::empty(strURI));
+				tc::cont_emplace_back(m_vecns, SNamespace{tc::make_str<char>(strPrefix), tc::make_str<char>(strURI)});
+				return tc::size(m_vecns) - 1;
+			}
+
+			// The element is in no namespace. An inherited default namespace is undeclared by xmlns="".
+			void begin_element(auto const& strName) & MAYTHROW {
+				BeginElement(tc::empty_range(), strName); // MAYTHROW
+				if (UnbindPrefix(tc::empty_range())) write(" xmlns=\"\""); // MAYTHROW
+			}
+
+			void begin_element(Namespace const ns, auto const& strName) & MAYTHROW {
+				BeginElement(m_vecns[ns].m_strPrefix, strName); // MAYTHROW
+				DeclareNamespace(ns); // MAYTHROW
+				tc::cont_emplace_back(m_vecnsStartTag, ns);
+			}
+
+			void attribute(auto const& strName, auto const& strValue) & MAYTHROW {
+				_ASSERT(m_bStartTag);
+				write(tc::concat(" ", strName, "=\"", tc::xml::encode_attribute(strValue), "\"")); // MAYTHROW
+			}
+
+			void attribute(Namespace const ns, auto const& strName, auto const& strValue) & MAYTHROW {
+				_ASSERT(m_bStartTag);
+				_ASSERT(!tc::empty(m_vecns[ns].m_strPrefix));
+				auto const nsAttribute = PrefixUsedOnStartTag(ns) ? NamespaceWithUnusedPrefix(ns) : ns;
+				DeclareNamespace(nsAttribute); // MAYTHROW
+				tc::cont_emplace_back(m_vecnsStartTag, nsAttribute);
+				write(tc::concat(" ", m_vecns[nsAttribute].m_strPrefix, ":", strName, "=\"", tc::xml::encode_attribute(strValue), "\"")); // MAYTHROW
+			}
+
+			void characters(auto const& str) & MAYTHROW {
+				EndStartTag(); // MAYTHROW
+				write(tc::xml::encode_characters(str)); // MAYTHROW
+			}
+
+			void end_element() & MAYTHROW {
+				_ASSERT(!tc::empty(m_vecnOpenElement));
+				if (m_bStartTag) {
+					write("/>"); // MAYTHROW
+					m_bStartTag = false;
+				} else {
+					write(tc::concat("</", tc::drop(m_strOpenElements, tc::begin(m_strOpenElements) + tc::back(m_vecnOpenElement)), ">")); // MAYTHROW
+				}
+				while (!tc::empty(m_stkbinding) && tc::size(m_vecnOpenElement) == tc::back(m_stkbinding).m_nDepth) {
+					m_vecns[tc::back(m_stkbinding).m_ns].m_bInScope = tc::back(m_stkbinding).m_bInScopeBefore;
+					tc::drop_last_inplace(m_stkbinding);
+				}
+				tc::take_first_inplace(m_strOpenElements, tc::back(m_vecnOpenElement));
+				tc::drop_last_inplace(m_vecnOpenElement);
+			}
+
+		private:
+			template<typename Rng>
+			void write(Rng const& rng) & MAYTHROW {
+				tc::for_each(rng, m_appender); // MAYTHROW
+			}
+
+			void EndStartTag() & MAYTHROW {
+				if (m_bStartTag) {
+					write(">"); // MAYTHROW
+					m_bStartTag = false;
+				}
+			}
+
+			void BeginElement(auto const& strPrefix, auto const& strName) & MAYTHROW {
+				EndStartTag(); // MAYTHROW
+				auto const nBegin = tc::size(m_strOpenElements);
+				tc::cont_emplace_back(m_vecnOpenElement, nBegin);
+				if (!tc::empty(strPrefix)) tc::append(m_strOpenElements, strPrefix, ":");
+				tc::append(m_strOpenElements, strName);
+				write(tc::concat("<", tc::drop(m_strOpenElements, tc::begin(m_strOpenElements) + nBegin))); // MAYTHROW
+				m_bStartTag = true;
+				tc::cont_assign(m_vecnsStartTag);
+			}
+
+			// Whether declaring ns on the current element would rebind a prefix that the element name or an attribute already uses.
+			bool PrefixUsedOnStartTag(Namespace const ns) const& noexcept {
+				return !m_vecns[ns].m_bInScope && tc::any_of(m_vecnsStartTag, [&](Namespace const nsUsed) noexcept {
+					return tc::equal(m_vecns[nsUsed].m_strPrefix, m_vecns[ns].m_strPrefix);
+				});
+			}
+
+			// Returns a namespace with the URI of ns whose prefix is not bound to another URI in the current scope, registering one if needed.
+			Namespace NamespaceWithUnusedPrefix(Namespace const ns) & noexcept {
+				for (int n = 1;; ++n) {
+					auto const strPrefix = tc::make_str<char>(m_vecns[ns].m_strPrefix, tc::as_dec(n));
+					if (tc::any_of(m_vecns, [&](SNamespace const& nsOther) noexcept {
+						return nsOther.m_bInScope && tc::equal(nsOther.m_strPrefix, strPrefix) && !tc::equal(nsOther.m_strURI, m_vecns[ns].m_strURI);
+					})) continue;
+					for (Namespace nsSameURI = 0; nsSameURI < tc::size(m_vecns); ++nsSameURI) {
+						if (tc::equal(m_vecns[nsSameURI].m_strPrefix, strPrefix) && tc::equal(m_vecns[nsSameURI].m_strURI, m_vecns[ns].m_strURI)) return nsSameURI;
+					}
+					return register_namespace(strPrefix, tc::make_str<char>(m_vecns[ns].m_strURI));
+				}
+			}
+
+			// Sets whether ns is in scope on the current element. The previous state is restored by end_element().
+			void Bind(Namespace const ns, bool const bInScope) & noexcept {
+				tc::cont_emplace_back(m_stkbinding, SBinding{tc::size(m_vecnOpenElement), ns, m_vecns[ns].m_bInScope});
+				m_vecns[ns].m_bInScope = bInScope;
+			}
+
+			// Takes strPrefix out of scope on the current element. Returns whether a namespace had been in scope with it.
+			bool UnbindPrefix(auto const& strPrefix) & noexcept {
+				bool bUnbound = false;
+				for (Namespace ns = 0; ns < tc::size(m_vecns); ++ns) {
+					if (m_vecns[ns].m_bInScope && tc::equal(m_vecns[ns].m_strPrefix, strPrefix)) {
+						Bind(ns, false);
+						bUnbound = true;
+					}
+				}
+				return bUnbound;
+			}
+
+			// Declares ns on the current element, unless it is in scope. Declaring it takes its prefix out of scope for all other namespaces.
+			void DeclareNamespace(Namespace const ns) & MAYTHROW {
+				_ASSERT(m_bStartTag);
+				if (m_vecns[ns].m_bInScope) return;
+				UnbindPrefix(m_vecns[ns].m_strPrefix);
+				Bind(ns, true);
+				auto const& strPrefix = m_vecns[ns].m_strPrefix;
+				if (tc::empty(strPrefix)) {
+					write(tc::concat(" xmlns=\"", tc::xml::encode_attribute(m_vecns[ns].m_strURI), "\"")); // MAYTHROW
+				} else {
+					write(tc::concat(" xmlns:", strPrefix, "=\"", tc::xml::encode_attribute(m_vecns[ns].m_strURI), "\"")); // MAYTHROW
+				}
+			}
+
+			struct SNamespace final {
+				tc::string<char> m_strPrefix;
+				tc::string<char> m_strURI;
+				bool m_bInScope = false;
+			};
+			struct SBinding final {
+				std::size_t m_nDepth; // the element on which the namespace has been declared or taken out of scope
+				Namespace m_ns;
+				bool m_bInScopeBefore;
+			};
+
+			Appender m_appender;
+			tc::vector<SNamespace> m_vecns;
+			tc::vector<SBinding> m_stkbinding;
+			tc::string<char> m_strOpenElements; // the qualified names of the open elements, concatenated
+			tc::vector<std::size_t> m_vecnOpenElement; // the beginnings of the names in m_strOpenElements
+			bool m_bStartTag = false; // the start tag of the innermost open element has not been closed by '>' yet
+			tc::vector<Namespace> m_vecnsStartTag; // the namespaces of the prefixes used on the current start tag
+		};
+	}
+	using no_adl::writer;
+}
@@ -0,0 +1,153 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "xmlwriter.h"
+#include "../range/transform_adaptor.h"
+
+#include <random>
+
+UNITTESTDEF(XMLEncode) {
+	_ASSERT(tc::equal(tc::make_str(tc::xml::encode_characters("")), ""));
+	_ASSERT(tc::equal(tc::make_str(tc::xml::encode_characters("abc")), "abc"));
+	_ASSERT(tc::equal(tc::make_str(tc::xml::encode_characters("a<b>&c\"d\n")), "a&lt;b&gt;&amp;c\"d\n"));
+	_ASSERT(tc::equal(tc::make_str(tc::xml::encode_attribute("a<b>&c\"d\t\n\r'")), "a&lt;b&gt;&amp;c&quot;d&#9;&#10;&#13;'"));
+	_ASSERT(tc::equal(tc::make_str(tc::xml::encode_attribute(tc::transform(tc::make_str("x\n\"y"), tc::identity()))), "x&#10;&quot;y")); // not contiguous
+	_ASSERT(tc::equal(tc::make_str<char16_t>(tc::xml::encode_characters(u"€<")), u"€&lt;"));
+	_ASSERTEQUAL(tc::size(tc::xml::encode_attribute("a<b>&c\"d\t\n\r'")), tc::size("a&lt;b&gt;&amp;c&quot;d&#9;&#10;&#13;'"));
+
+	// Round trip of random strings, long enough for vectorized scanning.
+	std::mt19937 gen(42);
+	for (int i = 0; i < 1000; ++i) {
+		tc::string<char> str;
+		auto const n = std::uniform_int_distribution<int>(0, 200)(gen);
+		for (int j = 0; j < n; ++j) {
+			tc::cont_emplace_back(str, "ab <>&\"'\t\n\r"[std::uniform_int_distribution<int>(0, 11)(gen)]);
+		}
+		auto const strEncoded = tc::make_str(tc::xml::encode_attribute(str));
+		_ASSERTEQUAL(tc::size(tc::xml::encode_attribute(str)), tc::size(strEncoded));
+		_ASSERT(tc::equal(tc::xml::decode(strEncoded), str));
+	}
+}
+
+UNITTESTDEF(XMLWriter) {
+	tc::string<char> str;
+	{
+		tc::xml::writer writer(tc::appender(str));
+		auto const nsA = writer.register_namespace("a", "urn:a");
+		auto const nsB = writer.register_namespace("b", "urn:b");
+		auto const nsA2 = writer.register_namespace("a", "urn:a2");
+		auto const nsDefault = writer.register_namespace("", "urn:default");
+		writer.begin_element(nsA, "root");
+		writer.attribute("x", "1 < 2");
+		writer.begin_element(nsA, "child");
+		writer.attribute(nsB, "y", "\"");
+		writer.characters("a & b");
+		writer.end_element();
+		writer.begin_element(nsA2, "child");
+		writer.begin_element(nsA, "grandchild");
+		writer.end_element();
+		writer.end_element();
+		writer.begin_element(nsDefault, "child");
+		writer.begin_element("empty");
+		writer.end_element();
+		writer.begin_element("noNamespace");
+		writer.begin_element("nested"); // the default namespace is out of scope already
+		writer.end_element();
+		writer.begin_element(nsDefault, "default");
+		writer.end_element();
+		writer.end_element();
+		writer.end_element();
+		writer.begin_element("top"); // no default namespace is in scope
+		writer.end_element();
+		writer.end_element();
+	}
+	_ASSERT(tc::equal(str,
+		R"(<a:root xmlns:a="urn:a" x="1 &lt; 2">)"
+			R"(<a:child xmlns:b="urn:b" b:y="&quot;">a &amp; b</a:child>)"
+			R"(<a:child xmlns:a="urn:a2"><a:grandchild xmlns:a="urn:a"/></a:child>)"
+			R"(<child xmlns="urn:default">)"
+				R"(<empty xmlns=""/>)"
+				R"(<noNamespace xmlns=""><nested/><default xmlns="urn:default"/></noNamespace>)"
+			R"(</child>)"
+			R"(<top/>)"
+		R"(</a:root>)"
+	));
+
+	auto parser = tc::xml::make_parser(str, tc::xml::throw_parse_error);
+	auto const nsA = parser.register_namespace("urn:a");
+	auto const nsA2 = parser.register_namespace("urn:a2");
+	auto const nsB = parser.register_namespace("urn:b");
+	auto const nsDefault = parser.register_namespace("urn:default");
+	parser.expect_child(nsA, "root");
+	_ASSERT(tc::equal(*parser.attribute("x"), "1 < 2"));
+	parser.expect_child(nsA, "child");
+	_ASSERT(tc::equal(*parser.attribute(nsB, "y"), "\""));
+	_ASSERT(tc::equal(parser.characters(), "a & b"));
+	parser.expect_element_end();
+	parser.expect_child(nsA2, "child");
+	parser.expect_child(nsA, "grandchild");
+	parser.expect_element_end();
+	parser.expect_element_end();
+	parser.expect_child(nsDefault, "child");
+	parser.expect_child("empty"); // in no namespace
+	parser.expect_element_end();
+	parser.expect_child("noNamespace");
+	parser.expect_child("nested");
+	parser.expect_element_end();
+	parser.expect_child(nsDefault, "default");
+	parser.expect_element_end();
+	parser.expect_element_end();
+	parser.expect_element_end();
+	parser.expect_child("top");
+	parser.expect_element_end();
+	parser.expect_element_end();
+	parser.expect_end();
+}
+
+UNITTESTDEF(XMLWriterPrefixConflict) {
+	tc::string<char> str;
+	{
+		tc::xml::writer writer(tc::appender(str));
+		auto const nsA = writer.register_namespace("a", "urn:a");
+		auto const nsA2 = writer.register_namespace("a", "urn:a2");
+		auto const nsA1 = writer.register_namespace("a1", "urn:a1");
+		writer.begin_element(nsA, "root");
+		writer.attribute(nsA1, "x", "0");
+		writer.attribute(nsA2, "y", "1"); // a and a1 are used on this start tag already
+		writer.attribute(nsA2, "z", "2");
+		writer.begin_element(nsA, "child");
+		writer.attribute(nsA2, "y", "3"); // a is bound by the parent and used by the element name
+		writer.end_element();
+		writer.begin_element(nsA2, "child");
+		writer.attribute(nsA, "y", "4");
+		writer.end_element();
+		writer.end_element();
+	}
+	_ASSERT(tc::equal(str,
+		R"(<a:root xmlns:a="urn:a" xmlns:a1="urn:a1" a1:x="0" xmlns:a2="urn:a2" a2:y="1" a2:z="2">)"
+			R"(<a:child a2:y="3"/>)"
+			R"(<a:child xmlns:a="urn:a2" xmlns:a3="urn:a" a3:y="4"/>)" // a1 and a2 are bound to other URIs
+		R"(</a:root>)"
+	));
+
+	auto parser = tc::xml::make_parser(str, tc::xml::throw_parse_error);
+	auto const nsA = parser.register_namespace("urn:a");
+	auto const nsA2 = parser.register_namespace("urn:a2");
+	parser.expect_child(nsA, "root");
+	_ASSERT(tc::equal(*parser.attribute(nsA2, "y"), "1"));
+	_ASSERT(tc::equal(*parser.attribute(nsA2, "z"), "2"));
+	parser.expect_child(nsA, "child");
+	_ASSERT(tc::equal(*parser.attribute(nsA2, "y"), "3"));
+	parser.expect_element_end();
+	parser.expect_child(nsA2, "child");
+	_ASSERT(tc::equal(*parser.attribute(nsA, "y"), "4"));
+	parser.expect_element_end();
+	parser.expect_element_end();
+	parser.expect_end();
+}